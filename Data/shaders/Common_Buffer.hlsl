@@ -108,3 +108,11 @@ cbuffer LightBuffer : register(b3)
     float4 cb_light_position;
     float4 cb_light_direction;
 };
+
+// High frequency - Updates per draw, indexed with SV_InstanceID
+static const uint g_max_instances = 64;
+cbuffer BufferInstances : register(b5)
+{
+    matrix g_instance_transform[g_max_instances];
+    matrix g_instance_transform_previous[g_max_instances];
+};
@@ -23,12 +23,14 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Common.hlsl"
 //====================
 
-Pixel_PosUv mainVS(Vertex_PosUv input)
+// g_transform is the view projection of the pass, every instance has its own world transform
+Pixel_PosUv mainVS(Vertex_PosUv input, uint instance_id : SV_InstanceID)
 {
     Pixel_PosUv output;
 
     input.position.w    = 1.0f; 
-    output.position     = mul(input.position, g_transform);
+    output.position     = mul(input.position, g_instance_transform[instance_id]);
+    output.position     = mul(output.position, g_transform);
     output.uv           = input.uv;
 
     return output;
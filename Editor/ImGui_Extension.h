@@ -64,7 +64,7 @@ public:
         auto resource_cache = g_resource_cache;
 
         // Load the model asynchronously
-        g_threading->AddTask([resource_cache, file_path]()
+        g_threading->AddTaskBackground([resource_cache, file_path]()
         {
             resource_cache->Load<Spartan::Model>(file_path);
         });
@@ -74,11 +74,12 @@ public:
     {
         auto world = g_world;
 
-        // Loading a world resets everything so it's important to ensure that no tasks are running
+        // Loading a world resets everything so it's important to ensure that no frame tasks are running.
+        // Background tasks (shader compilation, asset loading) are left alone, waiting on them would stall the UI.
         g_threading->Flush(true);
 
         // Load the scene asynchronously
-        g_threading->AddTask([world, file_path]()
+        g_threading->AddTaskBackground([world, file_path]()
         {
             world->LoadFromFile(file_path);
         });
@@ -89,7 +90,7 @@ public:
         auto world = g_world;
 
         // Save the scene asynchronously
-        g_threading->AddTask([world, file_path]()
+        g_threading->AddTaskBackground([world, file_path]()
         {
             world->SaveToFile(file_path);
         });
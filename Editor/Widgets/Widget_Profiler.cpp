@@ -51,7 +51,7 @@ void Widget_Profiler::OnHide()
     m_profiler->SetEnabled(false);
 }
 
-static void ShowTimeBlock(const TimeBlock& time_block, float total_time)
+static void ShowTimeBlock(const TimeBlock& time_block, float total_time, const map<string, TimeStatistics>& statistics)
 {
     if (!time_block.IsComplete())
         return;
@@ -71,7 +71,30 @@ static void ShowTimeBlock(const TimeBlock& time_block, float total_time)
     ImGui::GetWindowDrawList()->AddRectFilled(pos_screen, ImVec2(pos_screen.x + width, pos_screen.y + text_height), IM_COL32(color.x * 255, color.y * 255, color.z * 255, 255));
     // Text
     ImGui::SetCursorPos(ImVec2(pos.x + m_tree_depth_stride * time_block.GetTreeDepth(), pos.y));
-    ImGui::Text("%s - %.2f ms", name, duration);
+    const auto it = statistics.find(name);
+    if (it != statistics.end() && it->second.window.GetCount() != 0)
+    {
+        ImGui::Text("%s - %.2f ms (p99: %.2f ms)", name, duration, it->second.window.GetPercentile(99.0f));
+    }
+    else
+    {
+        ImGui::Text("%s - %.2f ms", name, duration);
+    }
+}
+
+static void ShowStatistics(const char* name, const Histogram& histogram, const float hitch_threshold_ms)
+{
+    ImGui::Text
+    (
+        "%s - p50:%.2f, p90:%.2f, p99:%.2f, p99.9:%.2f, Hitches (>%.1f ms):%llu",
+        name,
+        histogram.GetPercentile(50.0f),
+        histogram.GetPercentile(90.0f),
+        histogram.GetPercentile(99.0f),
+        histogram.GetPercentile(99.9f),
+        hitch_threshold_ms,
+        static_cast<unsigned long long>(histogram.GetCountAbove(hitch_threshold_ms))
+    );
 }
 
 void Widget_Profiler::TickVisible()
@@ -85,6 +108,18 @@ void Widget_Profiler::TickVisible()
     float interval = m_profiler->GetUpdateInterval();
     ImGui::DragFloat("Update interval (The smaller the interval the higher the performance impact)", &interval, 0.001f, 0.0f, 0.5f);
     m_profiler->SetUpdateInterval(interval);
+
+    // Trace capture
+    if (ImGui::Button("Capture trace") && !m_profiler->IsTraceCapturing())
+    {
+        m_profiler->TraceCapture(120, "trace.json");
+    }
+    ImGui::SameLine();
+    bool trace_on_stutter = m_profiler->IsTraceCapturingOnStutter();
+    if (ImGui::Checkbox("Capture trace on stutter", &trace_on_stutter))
+    {
+        m_profiler->SetTraceCaptureOnStutter(trace_on_stutter);
+    }
     ImGui::Separator();
 
     TimeBlockType type                          = m_item_type == 0 ? TimeBlockType::Cpu : TimeBlockType::Gpu;
@@ -92,13 +127,21 @@ void Widget_Profiler::TickVisible()
     const uint32_t time_block_count             = static_cast<uint32_t>(time_blocks.size());
     float time_last                             = type == TimeBlockType::Cpu ? m_profiler->GetTimeCpuLast() : m_profiler->GetTimeGpuLast();
 
-    // Time blocks
+    // Time blocks, grouped by the thread that recorded them
+    const map<string, TimeStatistics>& statistics = m_profiler->GetStatisticsTimeBlocks(type);
+    const char* thread_name = nullptr;
     for (uint32_t i = 0; i < time_block_count; i++)
     {
         if (time_blocks[i].GetType() != type)
             continue;
 
-        ShowTimeBlock(time_blocks[i], time_last);
+        if (time_blocks[i].GetThreadName() != thread_name)
+        {
+            thread_name = time_blocks[i].GetThreadName();
+            ImGui::TextDisabled("%s", thread_name ? thread_name : "unknown");
+        }
+
+        ShowTimeBlock(time_blocks[i], time_last, statistics);
     }
 
     // Plot
@@ -131,6 +174,23 @@ void Widget_Profiler::TickVisible()
             ImGui::TextColored(ImVec4(is_stuttering ? 1.0f : 0.0f, is_stuttering ? 0.0f : 1.0f, 0.0f, 1.0f), is_stuttering ? "Stuttering: Yes" : "Stuttering: No");
         }
 
+        // Percentiles, over the last complete window
+        {
+            const float hitch_threshold_ms = m_profiler->GetHitchThreshold();
+            ShowStatistics("Frame", m_profiler->GetStatisticsFrame().window, hitch_threshold_ms);
+            ShowStatistics(type == TimeBlockType::Cpu ? "CPU" : "GPU", (type == TimeBlockType::Cpu ? m_profiler->GetStatisticsCpu() : m_profiler->GetStatisticsGpu()).window, hitch_threshold_ms);
+
+            float window_sec = m_profiler->GetStatisticsWindow();
+            ImGui::PushItemWidth(100.0f);
+            ImGui::DragFloat("Window (sec)", &window_sec, 0.1f, 1.0f, 600.0f);
+            ImGui::SameLine();
+            float hitch_threshold = hitch_threshold_ms;
+            ImGui::DragFloat("Hitch threshold (ms)", &hitch_threshold, 0.1f, 1.0f, 1000.0f);
+            ImGui::PopItemWidth();
+            m_profiler->SetStatisticsWindow(window_sec);
+            m_profiler->SetHitchThreshold(hitch_threshold);
+        }
+
         // Shift plot to the left
         for (uint32_t i = 0; i < m_plot.size() - 1; i++)
         {
@@ -807,7 +807,9 @@ void Widget_Properties::ShowMaterial(Material* material) const
                         else
                         {
                             ImGui::PushID(static_cast<int>(ImGui::GetCursorPosX() + ImGui::GetCursorPosY()));
-                            ImGuiEx::DragFloatWrap("", &material->GetProperty(type), 0.004f, 0.0f, 1.0f);
+                            float value = material->GetProperty(type);
+                            ImGuiEx::DragFloatWrap("", &value, 0.004f, 0.0f, 1.0f);
+                            if (value != material->GetProperty(type)) material->SetProperty(type, value);
                             ImGui::PopID();
                         }
                     }
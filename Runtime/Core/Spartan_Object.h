@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ===================
 #include <string>
+#include <atomic>
 #include "Spartan_Definitions.h"
 //==============================
 
@@ -32,8 +33,8 @@ namespace Spartan
     class Context;
     //========================
 
-    // Globals
-    static uint32_t g_id = 0;
+    // Globals, shared by all translation units as objects can be created by any thread
+    inline std::atomic<uint32_t> g_id = 0;
 
     class SPARTAN_CLASS Spartan_Object
     {
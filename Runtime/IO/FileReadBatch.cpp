@@ -0,0 +1,117 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ======================
+#include "Spartan.h"
+#include "FileReadBatch.h"
+#include "../Threading/Threading.h"
+//=================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan
+{
+    FileReadBatch::FileReadBatch(Threading* threading)
+    {
+        m_threading = threading;
+    }
+
+    FileReadBatch::~FileReadBatch()
+    {
+        // The tasks reference this batch
+        Wait();
+    }
+
+    void FileReadBatch::Add(const string& file_path, Callback&& on_complete)
+    {
+        if (m_submitted)
+        {
+            LOG_ERROR("Can't add \"%s\", the batch has already been submitted", file_path.c_str());
+            return;
+        }
+
+        m_requests.push_back({ file_path, move(on_complete) });
+    }
+
+    void FileReadBatch::Submit(const TaskPriority completion_priority /*= TaskPriority::Normal*/)
+    {
+        if (m_submitted || m_requests.empty())
+            return;
+
+        m_submitted = true;
+
+        // One reader per background thread, each keeps picking up the next read until there are none left
+        const uint32_t reader_count = min(static_cast<uint32_t>(m_requests.size()), max(m_threading->GetBackgroundThreadCount(), 1u));
+        for (uint32_t i = 0; i < reader_count; i++)
+        {
+            m_threading->AddTaskBackground([this, completion_priority]() { ReadNext(completion_priority); }, &m_counter);
+        }
+    }
+
+    void FileReadBatch::Wait()
+    {
+        if (m_submitted)
+        {
+            m_threading->Wait(m_counter);
+        }
+    }
+
+    void FileReadBatch::ReadNext(const TaskPriority completion_priority)
+    {
+        for (uint32_t index = m_request_next.fetch_add(1); index < static_cast<uint32_t>(m_requests.size()); index = m_request_next.fetch_add(1))
+        {
+            vector<std::byte> data = ReadFile(m_requests[index].file_path);
+
+            // The reader moves on to the next file while the job system processes this one
+            m_threading->AddTask([this, index, data = move(data)]() mutable
+            {
+                Request& request = m_requests[index];
+                request.on_complete(request.file_path, move(data));
+            }, &m_counter, completion_priority);
+        }
+    }
+
+    vector<std::byte> FileReadBatch::ReadFile(const string& file_path)
+    {
+        vector<std::byte> data;
+
+        ifstream file(file_path, ios::binary | ios::ate);
+        if (!file.is_open())
+        {
+            LOG_ERROR("Failed to open \"%s\"", file_path.c_str());
+            return data;
+        }
+
+        data.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0, ios::beg);
+        file.read(reinterpret_cast<char*>(data.data()), static_cast<streamsize>(data.size()));
+
+        if (!file)
+        {
+            LOG_ERROR("Failed to read \"%s\"", file_path.c_str());
+            data.clear();
+        }
+
+        return data;
+    }
+}
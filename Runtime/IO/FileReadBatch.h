@@ -0,0 +1,86 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==================
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+#include "../Threading/Task.h"
+//=============================
+
+namespace Spartan
+{
+    class Threading;
+
+    // Reads many files asynchronously in a single batch. The reads are spread over the background lane of the
+    // thread pool and every completion is delivered to the job system as a task with the requested priority.
+    //
+    //  FileReadBatch batch(threading);
+    //  for (const std::string& file_path : file_paths)
+    //  {
+    //      batch.Add(file_path, [](const std::string& file_path, std::vector<std::byte>&& data) { FileStream stream(std::move(data)); ... });
+    //  }
+    //  batch.Submit();
+    //  batch.Wait();
+    class SPARTAN_CLASS FileReadBatch
+    {
+    public:
+        // The data is empty if the read failed
+        using Callback = std::function<void(const std::string& file_path, std::vector<std::byte>&& data)>;
+
+        FileReadBatch(Threading* threading);
+        ~FileReadBatch();
+
+        FileReadBatch(const FileReadBatch&)             = delete;
+        FileReadBatch& operator=(const FileReadBatch&)  = delete;
+
+        // Queues a read, nothing is read until Submit()
+        void Add(const std::string& file_path, Callback&& on_complete);
+
+        // Submits all the queued reads at once
+        void Submit(TaskPriority completion_priority = TaskPriority::Normal);
+
+        // Blocks until all reads and completions are done, the calling thread helps with queued tasks in the meantime
+        void Wait();
+        bool IsDone() const { return m_counter.IsDone(); }
+
+        // Reads a whole file on the calling thread
+        static std::vector<std::byte> ReadFile(const std::string& file_path);
+
+    private:
+        struct Request
+        {
+            std::string file_path;
+            Callback on_complete;
+        };
+
+        void ReadNext(TaskPriority completion_priority);
+
+        Threading* m_threading = nullptr;
+        std::vector<Request> m_requests;
+        std::atomic<uint32_t> m_request_next = 0;
+        bool m_submitted = false;
+        TaskCounter m_counter;
+    };
+}
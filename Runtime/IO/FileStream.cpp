@@ -22,7 +22,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =================
 #include "Spartan.h"
 #include "FileStream.h"
-#include "../RHI/RHI_Vertex.h"
+#include <windows.h>
 //============================
 
 //= NAMESPACES =====
@@ -49,6 +49,36 @@ namespace Spartan
                 LOG_ERROR("Failed to open \"%s\" for writing", path.c_str());
                 return;
             }
+
+            m_write_buffer.reserve(write_buffer_size);
+        }
+        else if (m_flags & FileStream_Mmap)
+        {
+            HANDLE file_handle = CreateFileW(FileSystem::StringToWstring(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file_handle == INVALID_HANDLE_VALUE)
+            {
+                LOG_ERROR("Failed to open \"%s\" for reading", path.c_str());
+                return;
+            }
+            m_file_handle = file_handle;
+
+            LARGE_INTEGER size = {};
+            GetFileSizeEx(file_handle, &size);
+            m_mapped_size = static_cast<uint64_t>(size.QuadPart);
+
+            // Empty files can't be mapped, but they are valid
+            if (m_mapped_size != 0)
+            {
+                m_mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                m_mapped_data    = m_mapping_handle ? static_cast<const std::byte*>(MapViewOfFile(m_mapping_handle, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+
+                if (!m_mapped_data)
+                {
+                    LOG_ERROR("Failed to map \"%s\"", path.c_str());
+                    Close();
+                    return;
+                }
+            }
         }
         else if (m_flags & FileStream_Read)
         {
@@ -63,6 +93,29 @@ namespace Spartan
         m_is_open = true;
     }
 
+    FileStream::FileStream()
+    {
+        m_flags     = FileStream_Write | FileStream_Memory;
+        m_is_open   = true;
+    }
+
+    FileStream::FileStream(vector<std::byte>&& data)
+    {
+        m_flags             = FileStream_Read | FileStream_Mmap;
+        m_memory            = move(data);
+        m_mapped_data       = m_memory.data();
+        m_mapped_size       = m_memory.size();
+        m_is_open           = true;
+    }
+
+    FileStream::FileStream(span<const std::byte> data)
+    {
+        m_flags             = FileStream_Read | FileStream_Mmap;
+        m_mapped_data       = data.data();
+        m_mapped_size       = data.size();
+        m_is_open           = true;
+    }
+
     FileStream::~FileStream()
     {
         Close();
@@ -72,9 +125,30 @@ namespace Spartan
     {
         if (m_flags & FileStream_Write)
         {
-            out.flush();
+            Flush();
             out.close();
         }
+        else if (m_flags & FileStream_Mmap)
+        {
+            if (m_mapping_handle)
+            {
+                if (m_mapped_data)
+                {
+                    UnmapViewOfFile(m_mapped_data);
+                }
+
+                CloseHandle(m_mapping_handle);
+                m_mapping_handle = nullptr;
+            }
+            m_mapped_data = nullptr;
+            m_memory.clear();
+
+            if (m_file_handle)
+            {
+                CloseHandle(m_file_handle);
+                m_file_handle = nullptr;
+            }
+        }
         else if (m_flags & FileStream_Read)
         {
             in.clear();
@@ -82,59 +156,90 @@ namespace Spartan
         }
     }
 
-    void FileStream::Write(const string& value)
+    void FileStream::Flush()
     {
-        const auto length = static_cast<uint32_t>(value.length());
-        Write(length);
+        // Memory streams keep everything in the buffer
+        if (m_flags & FileStream_Memory)
+            return;
+
+        if (!m_write_buffer.empty())
+        {
+            out.write(reinterpret_cast<const char*>(m_write_buffer.data()), static_cast<streamsize>(m_write_buffer.size()));
+            m_write_flushed += m_write_buffer.size();
+            m_write_buffer.clear();
+        }
 
-        out.write(const_cast<char*>(value.c_str()), length);
+        out.flush();
     }
 
-    void FileStream::Write(const vector<string>& value)
+    void FileStream::PatchBytes(const uint64_t position, const void* data, const uint64_t size)
     {
-        const auto size = static_cast<uint32_t>(value.size());
-        Write(size);
+        if (m_flags & FileStream_Append)
+        {
+            LOG_ERROR("Patching is not supported in append mode");
+            return;
+        }
 
-        for (uint32_t i = 0; i < size; i++)
+        if (position + size > GetWritePosition())
         {
-            Write(value[i]);
+            LOG_ERROR("Can't patch data which hasn't been written yet");
+            return;
         }
-    }
 
-    void FileStream::Write(const vector<RHI_Vertex_PosTexNorTan>& value)
-    {
-        const auto length = static_cast<uint32_t>(value.size());
-        Write(length);
-        out.write(reinterpret_cast<const char*>(&value[0]), sizeof(RHI_Vertex_PosTexNorTan) * length);
+        // Still buffered
+        if (position >= m_write_flushed)
+        {
+            memcpy(m_write_buffer.data() + (position - m_write_flushed), data, static_cast<size_t>(size));
+            return;
+        }
+
+        // Already in the file, the part which is still buffered is patched after the flush
+        const uint64_t size_file = size < m_write_flushed - position ? size : m_write_flushed - position;
+        out.seekp(static_cast<streamoff>(position));
+        out.write(reinterpret_cast<const char*>(data), static_cast<streamsize>(size_file));
+        out.seekp(static_cast<streamoff>(m_write_flushed));
+
+        if (size_file < size)
+        {
+            memcpy(m_write_buffer.data(), static_cast<const std::byte*>(data) + size_file, static_cast<size_t>(size - size_file));
+        }
     }
 
-    void FileStream::Write(const vector<uint32_t>& value)
+    void FileStream::Write(const string& value)
     {
-        const auto length = static_cast<uint32_t>(value.size());
+        const auto length = static_cast<uint32_t>(value.length());
         Write(length);
-        out.write(reinterpret_cast<const char*>(&value[0]), sizeof(uint32_t) * length);
-    }
 
-    void FileStream::Write(const vector<unsigned char>& value)
-    {
-        const auto size = static_cast<uint32_t>(value.size());
-        Write(size);
-        out.write(reinterpret_cast<const char*>(&value[0]), sizeof(unsigned char) * size);
+        WriteBytes(value.data(), length);
     }
 
-    void FileStream::Write(const vector<std::byte>& value)
+    void FileStream::Write(const vector<string>& value)
     {
         const auto size = static_cast<uint32_t>(value.size());
         Write(size);
-        out.write(reinterpret_cast<const char*>(&value[0]), sizeof(std::byte) * size);
+
+        for (uint32_t i = 0; i < size; i++)
+        {
+            Write(value[i]);
+        }
     }
 
     void FileStream::Skip(uint32_t n)
     {
         // Set the seek cursor to offset n from the current position
-        if (m_flags & FileStream_Write)
+        if (m_flags & FileStream_Memory)
         {
+            m_write_buffer.resize(m_write_buffer.size() + n);
+        }
+        else if (m_flags & FileStream_Write)
+        {
+            Flush();
             out.seekp(n, ios::cur);
+            m_write_flushed += n;
+        }
+        else if (m_flags & FileStream_Mmap)
+        {
+            m_mapped_position = m_mapped_position + n < m_mapped_size ? m_mapped_position + n : m_mapped_size;
         }
         else if (m_flags & FileStream_Read)
         {
@@ -148,7 +253,7 @@ namespace Spartan
         Read(&length);
 
         value->resize(length);
-        in.read(const_cast<char*>(value->c_str()), length);
+        ReadBytes(value->data(), length);
     }
 
     void FileStream::Read(vector<string>* vec)
@@ -170,67 +275,42 @@ namespace Spartan
         }
     }
 
-    void FileStream::Read(vector<RHI_Vertex_PosTexNorTan>* vec)
-    {
-        if (!vec)
-            return;
-
-        vec->clear();
-        vec->shrink_to_fit();
-
-        const auto length = ReadAs<uint32_t>();
-
-        vec->reserve(length);
-        vec->resize(length);
-
-        in.read(reinterpret_cast<char*>(vec->data()), sizeof(RHI_Vertex_PosTexNorTan) * length);
-    }
-
-    void FileStream::Read(vector<uint32_t>* vec)
-    {
-        if (!vec)
-            return;
-
-        vec->clear();
-        vec->shrink_to_fit();
-
-        const auto length = ReadAs<uint32_t>();
-
-        vec->reserve(length);
-        vec->resize(length);
-
-        in.read(reinterpret_cast<char*>(vec->data()), sizeof(uint32_t) * length);
-    }
-
-    void FileStream::Read(vector<unsigned char>* vec)
+    span<const std::byte> FileStream::ReadView()
     {
-        if (!vec)
-            return;
-
-        vec->clear();
-        vec->shrink_to_fit();
+        if (!m_mapped_data)
+        {
+            LOG_ERROR("Views can only be read in memory mapped mode");
+            return {};
+        }
 
-        const auto length = ReadAs<uint32_t>();
+        const uint64_t length = ReadAs<uint32_t>();
+        if (length > m_mapped_size - m_mapped_position)
+        {
+            LOG_ERROR("The view exceeds the end of the file");
+            m_mapped_position = m_mapped_size;
+            return {};
+        }
 
-        vec->reserve(length);
-        vec->resize(length);
+        span<const std::byte> view(m_mapped_data + m_mapped_position, static_cast<size_t>(length));
+        m_mapped_position += length;
 
-        in.read(reinterpret_cast<char*>(vec->data()), sizeof(unsigned char) * length);
+        return view;
     }
 
-    void FileStream::Read(vector<std::byte>* vec)
+    span<const std::byte> FileStream::GetView(const uint64_t offset, const uint64_t size) const
     {
-        if (!vec)
-            return;
-
-        vec->clear();
-        vec->shrink_to_fit();
-
-        const auto length = ReadAs<uint32_t>();
+        if (!m_mapped_data)
+        {
+            LOG_ERROR("Views can only be read in memory mapped mode");
+            return {};
+        }
 
-        vec->reserve(length);
-        vec->resize(length);
+        if (offset > m_mapped_size || size > m_mapped_size - offset)
+        {
+            LOG_ERROR("The view exceeds the end of the file");
+            return {};
+        }
 
-        in.read(reinterpret_cast<char*>(vec->data()), sizeof(std::byte) * length);
+        return span<const std::byte>(m_mapped_data + offset, static_cast<size_t>(size));
     }
 }
@@ -24,6 +24,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ===================
 #include <vector>
 #include <fstream>
+#include <span>
+#include <cstring>
+#include <type_traits>
 #include "../Math/Vector2.h"
 #include "../Math/Vector3.h"
 #include "../Math/Vector4.h"
@@ -40,121 +43,185 @@ namespace Spartan
         FileStream_Read     = 1 << 0,
         FileStream_Write    = 1 << 1,
         FileStream_Append   = 1 << 2,
+        FileStream_Mmap     = 1 << 3, // Read only, the file is memory mapped so arrays can be viewed without copying them
+        FileStream_Memory   = 1 << 4, // Write only, the data is kept in memory (see GetMemory()) so it can be written out later
     };
 
+    // Types which can be written and read as raw bytes
+    template <class T>
+    constexpr bool is_file_stream_pod = std::is_trivially_copyable_v<T> && !std::is_pointer_v<T>;
+
     class SPARTAN_CLASS FileStream
     {
     public:
         FileStream(const std::string& path, uint32_t flags);
+        // Writes to memory
+        FileStream();
+        // Reads from memory (e.g. the result of a FileReadBatch), behaves like the memory mapped mode
+        FileStream(std::vector<std::byte>&& data);
+        // Reads from memory which is owned by the caller, e.g. a view of a memory mapped stream
+        FileStream(std::span<const std::byte> data);
         ~FileStream();
 
         auto IsOpen() const { return m_is_open; }
         void Close();
 
         //= WRITING ==================================================
-        template <class T, class = typename std::enable_if<
-            std::is_same<T, bool>::value                ||
-            std::is_same<T, unsigned char>::value       ||        
-            std::is_same<T, int>::value                 ||
-            std::is_same<T, long>::value                ||
-            std::is_same<T, long long>::value           ||
-            std::is_same<T, uint8_t>::value             ||
-            std::is_same<T, uint16_t>::value            ||
-            std::is_same<T, uint32_t>::value            ||
-            std::is_same<T, uint64_t>::value            ||
-            std::is_same<T, unsigned long>::value       ||
-            std::is_same<T, unsigned long long>::value  ||
-            std::is_same<T, float>::value               ||
-            std::is_same<T, double>::value              ||
-            std::is_same<T, long double>::value         ||
-            std::is_same<T, std::byte>::value           ||
-            std::is_same<T, Math::Vector2>::value       ||
-            std::is_same<T, Math::Vector3>::value       ||
-            std::is_same<T, Math::Vector4>::value       ||
-            std::is_same<T, Math::Quaternion>::value    ||
-            std::is_same<T, Math::BoundingBox>::value
-        >::type>
+        template <class T, class = std::enable_if_t<is_file_stream_pod<T>>>
         void Write(T value)
         {
-            out.write(reinterpret_cast<char*>(&value), sizeof(value));
+            WriteBytes(&value, sizeof(T));
+        }
+
+        // Writes the element count, followed by the elements
+        template <class T, class = std::enable_if_t<is_file_stream_pod<T>>>
+        void WriteArray(const T* data, const uint32_t count)
+        {
+            Write(count);
+            WriteBytes(data, sizeof(T) * count);
+        }
+
+        template <class T, class = std::enable_if_t<is_file_stream_pod<T>>>
+        void Write(const std::vector<T>& value)
+        {
+            WriteArray(value.data(), static_cast<uint32_t>(value.size()));
         }
 
         void Write(const std::string& value);
         void Write(const std::vector<std::string>& value);
-        void Write(const std::vector<RHI_Vertex_PosTexNorTan>& value);
-        void Write(const std::vector<uint32_t>& value);
-        void Write(const std::vector<unsigned char>& value);
-        void Write(const std::vector<std::byte>& value);
         void Skip(uint32_t n);
+
+        // Writes the bytes as they are, without a size (e.g. data which was written to memory by another stream)
+        void WriteRaw(const std::span<const std::byte> data) { WriteBytes(data.data(), data.size()); }
+
+        // Writes a placeholder and returns its position, so that the value can be patched once it's known (e.g. a size or an offset)
+        template <class T, class = std::enable_if_t<is_file_stream_pod<T>>>
+        uint64_t Reserve()
+        {
+            const uint64_t position = GetWritePosition();
+            Write(T{});
+            return position;
+        }
+
+        // Overwrites a value which was written earlier, not supported in append mode
+        template <class T, class = std::enable_if_t<is_file_stream_pod<T>>>
+        void Patch(const uint64_t position, const T value)
+        {
+            PatchBytes(position, &value, sizeof(T));
+        }
+
+        // The number of bytes written so far
+        uint64_t GetWritePosition() const { return m_write_flushed + m_write_buffer.size(); }
+
+        // Writes out the buffered data, this also happens when the buffer is full and when the stream is closed
+        void Flush();
+
+        // Memory mode only, the data written so far
+        std::vector<std::byte>& GetMemory() { return m_write_buffer; }
         //===========================================================
         
         //= READING ===========================================
-        template <class T, class = typename std::enable_if
-        <
-            std::is_same<T, bool>::value                ||
-            std::is_same<T, unsigned char>::value       ||
-            std::is_same<T, int>::value                 ||
-            std::is_same<T, long>::value                ||
-            std::is_same<T, long long>::value           ||
-            std::is_same<T, uint8_t>::value             ||
-            std::is_same<T, uint16_t>::value            ||
-            std::is_same<T, uint32_t>::value            ||
-            std::is_same<T, uint64_t>::value            ||
-            std::is_same<T, unsigned long>::value       ||
-            std::is_same<T, unsigned long long>::value  ||
-            std::is_same<T, float>::value               ||
-            std::is_same<T, double>::value              ||
-            std::is_same<T, long double>::value         ||
-            std::is_same<T, std::byte>::value           ||
-            std::is_same<T, Math::Vector2>::value       ||
-            std::is_same<T, Math::Vector3>::value       ||
-            std::is_same<T, Math::Vector4>::value       ||
-            std::is_same<T, Math::Quaternion>::value    ||
-            std::is_same<T, Math::BoundingBox>::value
-        >::type>
+        template <class T, class = std::enable_if_t<is_file_stream_pod<T>>>
         void Read(T* value)
         {
-            in.read(reinterpret_cast<char*>(value), sizeof(T));
+            ReadBytes(value, sizeof(T));
+        }
+
+        // Reads the element count, followed by the elements
+        template <class T, class = std::enable_if_t<is_file_stream_pod<T>>>
+        void ReadArray(std::vector<T>* vec)
+        {
+            if (!vec)
+                return;
+
+            vec->clear();
+            vec->resize(ReadAs<uint32_t>());
+
+            ReadBytes(vec->data(), sizeof(T) * vec->size());
+        }
+
+        template <class T, class = std::enable_if_t<is_file_stream_pod<T>>>
+        void Read(std::vector<T>* vec)
+        {
+            ReadArray(vec);
         }
+
         void Read(std::string* value);
         void Read(std::vector<std::string>* vec);
-        void Read(std::vector<RHI_Vertex_PosTexNorTan>* vec);
-        void Read(std::vector<uint32_t>* vec);
-        void Read(std::vector<unsigned char>* vec);
-        void Read(std::vector<std::byte>* vec);
+
+        // Memory mapped mode only, returns a view of an array written by Write(const std::vector<std::byte>&), without copying it.
+        // The view is valid for as long as the stream is open.
+        std::span<const std::byte> ReadView();
+
+        // Memory mapped mode only, returns a view of size bytes at offset, the read position is not affected
+        std::span<const std::byte> GetView(uint64_t offset, uint64_t size) const;
 
         // Reading with explicit type definition
-        template <class T, class = typename std::enable_if
-        <
-            std::is_same<T, bool>::value                ||
-            std::is_same<T, unsigned char>::value       ||
-            std::is_same<T, int>::value                 ||
-            std::is_same<T, long>::value                ||
-            std::is_same<T, long long>::value           ||
-            std::is_same<T, uint8_t>::value             ||
-            std::is_same<T, uint16_t>::value            ||
-            std::is_same<T, uint32_t>::value            ||
-            std::is_same<T, uint64_t>::value            ||
-            std::is_same<T, unsigned long>::value       ||
-            std::is_same<T, unsigned long long>::value  ||
-            std::is_same<T, float>::value               ||
-            std::is_same<T, double>::value              ||
-            std::is_same<T, long double>::value         ||
-            std::is_same<T, std::byte>::value           ||
-            std::is_same<T, std::string>::value
-        >::type> 
+        template <class T, class = std::enable_if_t<is_file_stream_pod<T> || std::is_same_v<T, std::string>>>
         T ReadAs()
         {
-            T value;
+            T value = {};
             Read(&value);
             return value;
         }
         //=====================================================
 
     private:
+        void WriteBytes(const void* data, const uint64_t size)
+        {
+            if (!(m_flags & FileStream_Memory) && m_write_buffer.size() + size > write_buffer_size)
+            {
+                Flush();
+
+                // Too large to be worth buffering
+                if (size >= write_buffer_size)
+                {
+                    out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+                    m_write_flushed += size;
+                    return;
+                }
+            }
+
+            const size_t offset = m_write_buffer.size();
+            m_write_buffer.resize(offset + static_cast<size_t>(size));
+            memcpy(m_write_buffer.data() + offset, data, static_cast<size_t>(size));
+        }
+
+        void PatchBytes(uint64_t position, const void* data, uint64_t size);
+
+        void ReadBytes(void* destination, const uint64_t size)
+        {
+            if (m_mapped_data)
+            {
+                // Don't read past the end of the file
+                const uint64_t size_available   = m_mapped_size - m_mapped_position;
+                const uint64_t size_read        = size < size_available ? size : size_available;
+
+                memcpy(destination, m_mapped_data + m_mapped_position, static_cast<size_t>(size_read));
+                m_mapped_position += size_read;
+            }
+            else
+            {
+                in.read(reinterpret_cast<char*>(destination), static_cast<std::streamsize>(size));
+            }
+        }
+
         std::ofstream out;
         std::ifstream in;
         uint32_t m_flags;
         bool m_is_open;
+
+        // Write combining
+        static constexpr uint64_t write_buffer_size = 64 * 1024;
+        std::vector<std::byte> m_write_buffer;
+        uint64_t m_write_flushed = 0;
+
+        // Memory mapped mode
+        std::vector<std::byte> m_memory; // when reading from memory
+        void* m_file_handle             = nullptr;
+        void* m_mapping_handle          = nullptr;
+        const std::byte* m_mapped_data  = nullptr;
+        uint64_t m_mapped_size          = 0;
+        uint64_t m_mapped_position      = 0;
     };
 }
@@ -23,6 +23,10 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Spartan.h"
 #include "ILogger.h"
 #include <cstdarg>
+#include <thread>
+#include <chrono>
+#include <string_view>
+#include <unordered_map>
 #include "../World/Entity.h"
 //==========================
 
@@ -33,108 +37,317 @@ using namespace Spartan::Math;
 
 namespace Spartan
 {
+    // Messages with identical text per second, beyond which messages are suppressed
+    static constexpr uint32_t log_rate_limit = 32;
+
+    // The rate limit state of a message text, keyed by the hash of the text. Only used by the background thread.
+    struct LogRateState
+    {
+        uint64_t window_start   = 0; // milliseconds
+        uint32_t count          = 0;
+        uint32_t suppressed     = 0;
+        LogType type            = LogType::Info;
+        string text;                 // kept once a message is suppressed, so that it can be reported
+    };
+    static unordered_map<size_t, LogRateState> rate_states;
+
+    static void format_suppressed(const LogRateState& state, char (&buffer)[LogRecord::text_size])
+    {
+        snprintf(buffer, LogRecord::text_size, "%s (%u identical messages were suppressed)", state.text.c_str(), state.suppressed);
+    }
+
+    LogRecord Log::m_queue[Log::queue_size];
+    atomic<uint64_t> Log::m_queue_write     = 0;
+    atomic<uint64_t> Log::m_queue_read      = 0;
+    atomic<bool> Log::m_thread_running      = false;
     weak_ptr<ILogger> Log::m_logger;
     ofstream Log::m_fout;
     mutex Log::m_mutex_log;
+    mutex Log::m_mutex_logger;
     vector<LogCmd> Log::m_log_buffer;
     string Log::m_log_file_name = "log.txt";
-    bool Log::m_log_to_file     = true; // start logging to file (unless changed by the user, e.g. Renderer initialization was successful, so logging can happen on screen)
+    atomic<bool> Log::m_log_to_file = true; // start logging to file (unless changed by the user, e.g. Renderer initialization was successful, so logging can happen on screen)
     bool Log::m_first_log       = true;
-   
-    // Everything resolves to this
-    void Log::Write(const char* text, const LogType type)
+
+    // Drains the queue, it's started by the first message and stopped when the program exits
+    class LogThread
     {
-        if (!text)
+    public:
+        LogThread()
         {
-            LOG_ERROR_INVALID_PARAMETER();
-            return;
+            Log::m_thread_running = true;
+            m_thread = thread(&Log::Process);
         }
 
-        lock_guard<mutex> guard(m_mutex_log);
+        ~LogThread()
+        {
+            // Any messages after this point are handled by the calling thread
+            Log::m_thread_running = false;
 
-        const bool log_to_file = m_logger.expired() || m_log_to_file;
+            // Wake the thread up with an empty message
+            uint64_t position   = 0;
+            LogRecord* record   = Log::Acquire(&position);
+            record->text[0]     = '\0';
+            Log::Publish(record, position);
 
-        if (log_to_file)
-        {
-            m_log_buffer.emplace_back(text, type);
-            LogToFile(text, type);
+            m_thread.join();
         }
-        else
+
+    private:
+        thread m_thread;
+    };
+
+    static void start_thread()
+    {
+        static LogThread log_thread;
+    }
+
+    static uint64_t get_time_ms()
+    {
+        return static_cast<uint64_t>(chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // Reserves the next record, the sequence of a record is relative to its index so that it starts at zero
+    LogRecord* Log::Acquire(uint64_t* position_out)
+    {
+        uint64_t position = m_queue_write.load(memory_order_relaxed);
+        while (true)
         {
-            FlushBuffer();
-            LogString(text, type);
+            LogRecord& record           = m_queue[position % queue_size];
+            const uint64_t sequence     = record.sequence.load(memory_order_acquire) + position % queue_size;
+            const int64_t difference    = static_cast<int64_t>(sequence - position);
+
+            if (difference == 0)
+            {
+                // The record is free, claim it
+                if (m_queue_write.compare_exchange_weak(position, position + 1, memory_order_relaxed))
+                {
+                    *position_out = position;
+                    return &record;
+                }
+            }
+            else if (difference < 0)
+            {
+                // The queue is full, wait for the background thread to catch up
+                this_thread::yield();
+                position = m_queue_write.load(memory_order_relaxed);
+            }
+            else
+            {
+                // Another thread claimed it
+                position = m_queue_write.load(memory_order_relaxed);
+            }
         }
     }
 
-    void Log::WriteFInfo(const char* text, ...)
+    void Log::Publish(LogRecord* record, const uint64_t position)
     {
-        char buffer[1024];
-        va_list args;
-        va_start(args, text);
-        auto w = vsnprintf(buffer, sizeof(buffer), text, args);
-        va_end(args);
+        // The record is ready to be read once its sequence is its position + 1
+        record->sequence.store(position + 1 - position % queue_size, memory_order_release);
+        m_queue_write.notify_one();
+    }
 
-        Write(buffer, LogType::Info);
+    void Log::Process()
+    {
+        uint64_t position       = m_queue_read.load(memory_order_relaxed);
+        uint64_t time_flushed   = 0;
+        while (true)
+        {
+            LogRecord& record       = m_queue[position % queue_size];
+            const uint64_t index    = position % queue_size;
+
+            if (record.sequence.load(memory_order_acquire) + index == position + 1)
+            {
+                if (record.text[0] != '\0')
+                {
+                    const uint64_t time = get_time_ms();
+                    if (RateLimit(record.text, record.type, time))
+                    {
+                        Consume(record.text, record.type);
+                    }
+
+                    // Report the windows which ended while the queue was busy
+                    if (time - time_flushed >= 1000)
+                    {
+                        FlushSuppressed(time, false);
+                        time_flushed = time;
+                    }
+                }
+
+                // Hand the record back to the writers, for the next lap around the queue
+                record.sequence.store(position + queue_size - index, memory_order_release);
+                m_queue_read.store(++position, memory_order_release);
+                m_queue_read.notify_all();
+                continue;
+            }
+
+            if (!m_thread_running && m_queue_write.load(memory_order_acquire) == position)
+            {
+                FlushSuppressed(get_time_ms(), true);
+                break;
+            }
+
+            // Nothing to read, report the suppressed messages whose window has ended
+            // and make sure that everything which has been read is in the file before sleeping
+            FlushSuppressed(get_time_ms(), false);
+            {
+                lock_guard<mutex> guard(m_mutex_log);
+                m_fout.flush();
+            }
+
+            // Sleep until a record is claimed, a record which is claimed but not published yet is waited for by spinning.
+            // While windows are still open, sleep for short periods instead, so that their suppressed messages are reported.
+            const uint64_t position_write = m_queue_write.load(memory_order_acquire);
+            if (position_write != position)
+            {
+                this_thread::yield();
+            }
+            else if (!rate_states.empty())
+            {
+                this_thread::sleep_for(chrono::milliseconds(10));
+            }
+            else
+            {
+                m_queue_write.wait(position_write, memory_order_acquire);
+            }
+        }
     }
 
-    void Log::WriteFWarning(const char* text, ...)
+    // Returns false if the message exceeds the rate limit of its text, the count starts over every second
+    bool Log::RateLimit(const char* text, const LogType type, const uint64_t time)
     {
-        char buffer[1024];
-        va_list args;
-        va_start(args, text);
-        auto w = vsnprintf(buffer, sizeof(buffer), text, args);
-        va_end(args);
+        LogRateState& state = rate_states[hash<string_view>{}(string_view(text))];
+
+        if (time - state.window_start >= 1000)
+        {
+            // Report the previous window before starting a new one
+            if (state.suppressed != 0)
+            {
+                char buffer[LogRecord::text_size];
+                format_suppressed(state, buffer);
+                Consume(buffer, state.type);
+
+                state.suppressed = 0;
+                state.text.clear();
+            }
+
+            state.window_start  = time;
+            state.count         = 0;
+        }
 
-        Write(buffer, LogType::Warning);
+        if (++state.count <= log_rate_limit)
+            return true;
+
+        if (state.suppressed++ == 0)
+        {
+            state.text = text;
+            state.type = type;
+        }
+
+        return false;
     }
 
-    void Log::WriteFError(const char* text, ...)
+    // Reports and forgets the texts whose window has ended (or all of them if forced)
+    void Log::FlushSuppressed(const uint64_t time, const bool force)
     {
-        char buffer[1024];
-        va_list args;
-        va_start(args, text);
-        auto w = vsnprintf(buffer, sizeof(buffer), text, args);
-        va_end(args);
+        for (auto it = rate_states.begin(); it != rate_states.end();)
+        {
+            const LogRateState& state = it->second;
+            if (!force && time - state.window_start < 1000)
+            {
+                ++it;
+                continue;
+            }
+
+            if (state.suppressed != 0)
+            {
+                char buffer[LogRecord::text_size];
+                format_suppressed(state, buffer);
+                Consume(buffer, state.type);
+            }
+
+            it = rate_states.erase(it);
+        }
+    }
+
+    void Log::Flush()
+    {
+        const uint64_t position_write = m_queue_write.load(memory_order_acquire);
+
+        uint64_t position_read = m_queue_read.load(memory_order_acquire);
+        while (m_thread_running && position_read < position_write)
+        {
+            m_queue_read.wait(position_read, memory_order_acquire);
+            position_read = m_queue_read.load(memory_order_acquire);
+        }
 
-        Write(buffer, LogType::Error);
+        lock_guard<mutex> guard(m_mutex_log);
+        m_fout.flush();
     }
 
-    void Log::Write(const string& text, const LogType type)
+    void Log::SetLogger(const weak_ptr<ILogger>& logger)
     {
-        Write(text.c_str(), type);
+        lock_guard<mutex> guard(m_mutex_logger);
+        m_logger = logger;
     }
 
-    void Log::WriteFInfo(const string text, ...)
+    void Log::Write(const char* text, const LogType type)
     {
-        char buffer[2048];
-        va_list args;
-        va_start(args, text);
-        auto w = vsnprintf(buffer, sizeof(buffer), text.c_str(), args);
-        va_end(args);
+        if (!text)
+        {
+            LOG_ERROR_INVALID_PARAMETER();
+            return;
+        }
+
+        // Start the background thread with the first message
+        start_thread();
 
-        Write(buffer, LogType::Info);
+        // Once the background thread has stopped, messages are handled right away
+        if (!m_thread_running)
+        {
+            Consume(text, type);
+            return;
+        }
+
+        uint64_t position   = 0;
+        LogRecord* record   = Acquire(&position);
+        record->type        = type;
+        strncpy_s(record->text, text, _TRUNCATE);
+        Publish(record, position);
     }
 
-    void Log::WriteFWarning(const string text, ...)
+    void Log::WriteF(const LogType type, const char* function, const char* text, ...)
     {
-        char buffer[2048];
-        va_list args;
-        va_start(args, text);
-        auto w = vsnprintf(buffer, sizeof(buffer), text.c_str(), args);
-        va_end(args);
+        // Format directly into the record, so that nothing is allocated
+        start_thread();
+        uint64_t position   = 0;
+        LogRecord* record   = m_thread_running ? Acquire(&position) : nullptr;
+        char buffer[LogRecord::text_size];
+        char* destination   = record ? record->text : buffer;
+
+        const int length = snprintf(destination, LogRecord::text_size, "%s: ", function);
+        if (length >= 0 && length < static_cast<int>(LogRecord::text_size))
+        {
+            va_list args;
+            va_start(args, text);
+            vsnprintf(destination + length, LogRecord::text_size - length, text, args);
+            va_end(args);
+        }
 
-        Write(buffer, LogType::Warning);
+        if (record)
+        {
+            record->type = type;
+            Publish(record, position);
+        }
+        else
+        {
+            Consume(buffer, type);
+        }
     }
 
-    void Log::WriteFError(const string text, ...)
+    void Log::Write(const string& text, const LogType type)
     {
-        char buffer[2048];
-        va_list args;
-        va_start(args, text);
-        auto w = vsnprintf(buffer, sizeof(buffer), text.c_str(), args);
-        va_end(args);
-
-        Write(buffer, LogType::Error);
+        Write(text.c_str(), type);
     }
 
     void Log::Write(const weak_ptr<Entity>& entity, const LogType type)
@@ -172,58 +385,56 @@ namespace Spartan
         Write(value.ToString(), type);
     }
 
-    void Log::FlushBuffer()
+    // Everything resolves to this, it runs on the background thread
+    void Log::Consume(const char* text, const LogType type)
     {
-        if (m_logger.expired() || m_log_buffer.empty())
-            return;
+        shared_ptr<ILogger> logger;
+        {
+            lock_guard<mutex> guard(m_mutex_logger);
+            logger = m_logger.lock();
+        }
 
-         // Log everything from memory to the logger implementation
-        for (const auto& log : m_log_buffer)
+        lock_guard<mutex> guard(m_mutex_log);
+
+        if (!logger || m_log_to_file)
         {
-            LogString(log.text.c_str(), log.type);
+            m_log_buffer.emplace_back(text, type);
+            LogToFile(text, type);
+        }
+        else
+        {
+            FlushBuffer(logger.get());
+            logger->Log(string(text), static_cast<uint32_t>(type));
         }
-        m_log_buffer.clear();
     }
 
-    void Log::LogString(const char* text, const LogType type)
+    void Log::FlushBuffer(ILogger* logger)
     {
-        if (!text)
-        {
-            LOG_ERROR_INVALID_PARAMETER();
+        if (m_log_buffer.empty())
             return;
-        }
 
-        m_logger.lock()->Log(string(text), static_cast<uint32_t>(type));
+         // Log everything from memory to the logger implementation
+        for (const auto& log : m_log_buffer)
+        {
+            logger->Log(log.text, static_cast<uint32_t>(log.type));
+        }
+        m_log_buffer.clear();
     }
 
     void Log::LogToFile(const char* text, const LogType type)
     {
-        if (!text)
-        {
-            LOG_ERROR_INVALID_PARAMETER();
-            return;
-        }
-
-        const string prefix        = (type == LogType::Info) ? "Info:" : (type == LogType::Warning) ? "Warning:" : "Error:";
-        const auto final_text    = prefix + " " + text;
-
-        // Delete the previous log file (if it exists)
+        // Delete the previous log file (if it exists) and keep the new one open
         if (m_first_log)
         {
             FileSystem::Delete(m_log_file_name);
+            m_fout.open(m_log_file_name, ofstream::out | ofstream::app);
             m_first_log = false;
         }
 
-        // Open/Create a log file to write the error message to
-        m_fout.open(m_log_file_name, ofstream::out | ofstream::app);
-
         if (m_fout.is_open())
         {
-            // Write out the error message
-            m_fout << final_text << endl;
-
-            // Close the file
-            m_fout.close();
+            const char* prefix = (type == LogType::Info) ? "Info: " : (type == LogType::Warning) ? "Warning: " : "Error: ";
+            m_fout << prefix << text << '\n';
         }
     }
 }
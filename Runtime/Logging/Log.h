@@ -26,14 +26,21 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <memory>
 #include <mutex>
 #include <vector>
+#include <atomic>
 #include "../Core/Spartan_Definitions.h"
 //======================================
 
+// Messages below this level are compiled out (0 = Info, 1 = Warning, 2 = Error)
+#ifndef SP_LOG_LEVEL
+#define SP_LOG_LEVEL 0
+#endif
+
 namespace Spartan
 {
-    #define LOG_INFO(text, ...)        { Spartan::Log::WriteFInfo(std::string(__FUNCTION__)    + ": " + std::string(text), __VA_ARGS__); }
-    #define LOG_WARNING(text, ...)    { Spartan::Log::WriteFWarning(std::string(__FUNCTION__) + ": " + std::string(text), __VA_ARGS__); }
-    #define LOG_ERROR(text, ...)    { Spartan::Log::WriteFError(std::string(__FUNCTION__)   + ": " + std::string(text), __VA_ARGS__); }
+    // The messages below SP_LOG_LEVEL are compiled out
+    #define LOG_INFO(text, ...)     { if constexpr (SP_LOG_LEVEL <= 0) { Spartan::Log::WriteF(Spartan::LogType::Info,    __FUNCTION__, Spartan::Log::ToCstr(text), __VA_ARGS__); } }
+    #define LOG_WARNING(text, ...)  { if constexpr (SP_LOG_LEVEL <= 1) { Spartan::Log::WriteF(Spartan::LogType::Warning, __FUNCTION__, Spartan::Log::ToCstr(text), __VA_ARGS__); } }
+    #define LOG_ERROR(text, ...)    { if constexpr (SP_LOG_LEVEL <= 2) { Spartan::Log::WriteF(Spartan::LogType::Error,   __FUNCTION__, Spartan::Log::ToCstr(text), __VA_ARGS__); } }
 
     // Standard errors
     #define LOG_ERROR_GENERIC_FAILURE()        LOG_ERROR("Failed.")
@@ -45,6 +52,7 @@ namespace Spartan
 
     // Forward declarations
     class Entity;
+    class ILogger;
     namespace Math
     {
         class Quaternion;
@@ -73,6 +81,19 @@ namespace Spartan
         LogType type;
     };
 
+    // A formatted message in the queue
+    struct LogRecord
+    {
+        static constexpr uint32_t text_size = 1024;
+
+        std::atomic<uint64_t> sequence = 0; // relative to the record's index in the queue, so that zero initialization is valid
+        LogType type                   = LogType::Info;
+        char text[text_size]           = {};
+    };
+
+    // Messages are formatted on the calling thread (without allocating) and pushed into a lock-free queue.
+    // A background thread drains the queue, writes the log file and forwards the messages to the logger.
+    // It also rate limits messages with identical text, and reports how many were suppressed once their window ends.
     class SPARTAN_CLASS Log
     {
         friend class ILogger;
@@ -80,17 +101,19 @@ namespace Spartan
         Log() = default;
 
         // Set a logger to be used (if not set, logging will done in a text file.
-        static void SetLogger(const std::weak_ptr<ILogger>& logger) { m_logger = logger; }
+        static void SetLogger(const std::weak_ptr<ILogger>& logger);
+
+        // Blocks until every message which has been written so far is in the log file or the logger
+        static void Flush();
+
+        // Used by LOG_INFO/WARNING/ERROR
+        static void WriteF(LogType type, const char* function, const char* text, ...);
+        static const char* ToCstr(const char* text)           { return text; }
+        static const char* ToCstr(const std::string& text)    { return text.c_str(); }
 
         // Alpha
         static void Write(const char* text, const LogType type);
-        static void WriteFInfo(const char* text, ...);
-        static void WriteFWarning(const char* text, ...);
-        static void WriteFError(const char* text, ...);
         static void Write(const std::string& text, const LogType type);
-        static void WriteFInfo(const std::string text, ...);
-        static void WriteFWarning(const std::string text, ...);
-        static void WriteFError(const std::string text, ...);
 
         // Numeric
         template <class T, class = typename std::enable_if<
@@ -123,14 +146,29 @@ namespace Spartan
         static void Write(const std::weak_ptr<Entity>& entity, LogType type);
         static void Write(const std::shared_ptr<Entity>& entity, LogType type);
 
-        static bool m_log_to_file;     
+        static std::atomic<bool> m_log_to_file;
 
     private:
-        static void FlushBuffer();
-        static void LogString(const char* text, LogType type);
+        friend class LogThread;
+        static LogRecord* Acquire(uint64_t* position);
+        static void Publish(LogRecord* record, uint64_t position);
+        static void Process();
+        static void Consume(const char* text, LogType type);
+        static bool RateLimit(const char* text, LogType type, uint64_t time);
+        static void FlushSuppressed(uint64_t time, bool force);
+        static void FlushBuffer(ILogger* logger);
         static void LogToFile(const char* text, LogType type);
 
+        // Queue, fixed size and zero initialized so that it can be used at any point of static initialization
+        static constexpr uint64_t queue_size = 512;
+        static LogRecord m_queue[queue_size];
+        static std::atomic<uint64_t> m_queue_write;
+        static std::atomic<uint64_t> m_queue_read;
+        static std::atomic<bool> m_thread_running;
+
+        // Used by the background thread, or by the calling thread once the background thread has stopped
         static std::mutex m_mutex_log;
+        static std::mutex m_mutex_logger;
         static std::weak_ptr<ILogger> m_logger;
         static std::ofstream m_fout;    
         static std::string m_log_file_name;
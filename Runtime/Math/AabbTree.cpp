@@ -0,0 +1,355 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= INCLUDES ==========
+#include "Spartan.h"
+#include "AabbTree.h"
+//=====================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan::Math
+{
+    static BoundingBox merge(const BoundingBox& a, const BoundingBox& b)
+    {
+        BoundingBox box = a;
+        box.Merge(b);
+        return box;
+    }
+
+    // The cost of a node is proportional to the probability of a query hitting it, which is proportional to its surface area
+    static float surface_area(const BoundingBox& box)
+    {
+        const Vector3 size = box.GetSize();
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    static bool contains(const BoundingBox& outer, const BoundingBox& inner)
+    {
+        return outer.IsInside(inner) == Inside;
+    }
+
+    uint32_t AabbTree::ProxyCreate(const BoundingBox& box, void* user_data)
+    {
+        const uint32_t proxy = NodeAllocate();
+
+        const Vector3 margin        = Vector3(m_margin, m_margin, m_margin);
+        m_nodes[proxy].box          = BoundingBox(box.GetMin() - margin, box.GetMax() + margin);
+        m_nodes[proxy].user_data    = user_data;
+        m_nodes[proxy].height       = 0;
+        m_boxes_tight[proxy]        = box;
+
+        LeafInsert(proxy);
+        m_proxy_count++;
+
+        return proxy;
+    }
+
+    void AabbTree::ProxyDestroy(const uint32_t proxy)
+    {
+        SP_ASSERT(proxy < m_nodes.size() && m_nodes[proxy].IsLeaf());
+
+        LeafRemove(proxy);
+        NodeFree(proxy);
+        m_proxy_count--;
+    }
+
+    bool AabbTree::ProxyMove(const uint32_t proxy, const BoundingBox& box)
+    {
+        SP_ASSERT(proxy < m_nodes.size() && m_nodes[proxy].IsLeaf());
+
+        m_boxes_tight[proxy] = box;
+
+        // Still within the enlarged box, the tree doesn't have to change
+        if (contains(m_nodes[proxy].box, box))
+            return false;
+
+        LeafRemove(proxy);
+
+        const Vector3 margin    = Vector3(m_margin, m_margin, m_margin);
+        m_nodes[proxy].box      = BoundingBox(box.GetMin() - margin, box.GetMax() + margin);
+
+        LeafInsert(proxy);
+
+        return true;
+    }
+
+    void AabbTree::Clear()
+    {
+        m_nodes.clear();
+        m_boxes_tight.clear();
+        m_root          = null;
+        m_free_list     = null;
+        m_proxy_count   = 0;
+    }
+
+    uint32_t AabbTree::NodeAllocate()
+    {
+        // Grow the pool and link the new nodes into the free list
+        if (m_free_list == null)
+        {
+            const uint32_t count        = static_cast<uint32_t>(m_nodes.size());
+            const uint32_t count_new    = count == 0 ? 16 : count * 2;
+
+            m_nodes.resize(count_new);
+            m_boxes_tight.resize(count_new);
+            for (uint32_t i = count; i < count_new; i++)
+            {
+                m_nodes[i].parent = i + 1 < count_new ? i + 1 : null;
+                m_nodes[i].height = -1;
+            }
+            m_free_list = count;
+        }
+
+        const uint32_t index    = m_free_list;
+        Node& node              = m_nodes[index];
+        m_free_list             = node.parent;
+        node.parent             = null;
+        node.child_left         = null;
+        node.child_right        = null;
+        node.user_data          = nullptr;
+        node.height             = 0;
+
+        return index;
+    }
+
+    void AabbTree::NodeFree(const uint32_t index)
+    {
+        m_nodes[index].parent   = m_free_list;
+        m_nodes[index].height   = -1;
+        m_free_list             = index;
+    }
+
+    void AabbTree::LeafInsert(const uint32_t leaf)
+    {
+        if (m_root == null)
+        {
+            m_root                  = leaf;
+            m_nodes[leaf].parent    = null;
+            return;
+        }
+
+        // Descend towards the sibling which minimizes the surface area added to the tree
+        const BoundingBox leaf_box = m_nodes[leaf].box; // copied, allocating the new parent can grow the pool
+        uint32_t index = m_root;
+        while (!m_nodes[index].IsLeaf())
+        {
+            const Node& node        = m_nodes[index];
+            const float area        = surface_area(node.box);
+            const float area_merged = surface_area(merge(node.box, leaf_box));
+
+            // Cost of creating a new parent for this node and the leaf
+            const float cost = 2.0f * area_merged;
+
+            // Minimum cost of pushing the leaf further down the tree, every ancestor of the new parent grows by the same amount
+            const float cost_inheritance = 2.0f * (area_merged - area);
+
+            const auto cost_descend = [this, &leaf_box, cost_inheritance](const uint32_t child)
+            {
+                const Node& node_child  = m_nodes[child];
+                const float area_new    = surface_area(merge(leaf_box, node_child.box));
+                return node_child.IsLeaf() ? area_new + cost_inheritance : (area_new - surface_area(node_child.box)) + cost_inheritance;
+            };
+
+            const float cost_left   = cost_descend(node.child_left);
+            const float cost_right  = cost_descend(node.child_right);
+
+            if (cost < cost_left && cost < cost_right)
+                break;
+
+            index = cost_left < cost_right ? node.child_left : node.child_right;
+        }
+
+        // Create a new parent for the sibling and the leaf
+        const uint32_t sibling          = index;
+        const uint32_t parent_old       = m_nodes[sibling].parent;
+        const uint32_t parent_new       = NodeAllocate();
+        m_nodes[parent_new].parent      = parent_old;
+        m_nodes[parent_new].box         = merge(leaf_box, m_nodes[sibling].box);
+        m_nodes[parent_new].height      = m_nodes[sibling].height + 1;
+        m_nodes[parent_new].child_left  = sibling;
+        m_nodes[parent_new].child_right = leaf;
+        m_nodes[sibling].parent         = parent_new;
+        m_nodes[leaf].parent            = parent_new;
+
+        if (parent_old != null)
+        {
+            if (m_nodes[parent_old].child_left == sibling)
+            {
+                m_nodes[parent_old].child_left = parent_new;
+            }
+            else
+            {
+                m_nodes[parent_old].child_right = parent_new;
+            }
+        }
+        else
+        {
+            m_root = parent_new;
+        }
+
+        // Walk back up, refitting and rebalancing the ancestors
+        index = m_nodes[leaf].parent;
+        while (index != null)
+        {
+            index = Balance(index);
+
+            Node& node          = m_nodes[index];
+            const Node& left    = m_nodes[node.child_left];
+            const Node& right   = m_nodes[node.child_right];
+            node.height         = 1 + Helper::Max(left.height, right.height);
+            node.box            = merge(left.box, right.box);
+
+            index = node.parent;
+        }
+    }
+
+    void AabbTree::LeafRemove(const uint32_t leaf)
+    {
+        if (leaf == m_root)
+        {
+            m_root = null;
+            return;
+        }
+
+        const uint32_t parent       = m_nodes[leaf].parent;
+        const uint32_t grandparent  = m_nodes[parent].parent;
+        const uint32_t sibling      = m_nodes[parent].child_left == leaf ? m_nodes[parent].child_right : m_nodes[parent].child_left;
+
+        // Replace the parent with the sibling
+        if (grandparent != null)
+        {
+            if (m_nodes[grandparent].child_left == parent)
+            {
+                m_nodes[grandparent].child_left = sibling;
+            }
+            else
+            {
+                m_nodes[grandparent].child_right = sibling;
+            }
+            m_nodes[sibling].parent = grandparent;
+            NodeFree(parent);
+
+            // Walk back up, refitting and rebalancing the ancestors
+            uint32_t index = grandparent;
+            while (index != null)
+            {
+                index = Balance(index);
+
+                Node& node          = m_nodes[index];
+                const Node& left    = m_nodes[node.child_left];
+                const Node& right   = m_nodes[node.child_right];
+                node.box            = merge(left.box, right.box);
+                node.height         = 1 + Helper::Max(left.height, right.height);
+
+                index = node.parent;
+            }
+        }
+        else
+        {
+            m_root                  = sibling;
+            m_nodes[sibling].parent = null;
+            NodeFree(parent);
+        }
+
+        m_nodes[leaf].parent = null;
+    }
+
+    // Rotates the taller grandchild up if the children of a node differ in height by more than one, returns the node which took its place
+    uint32_t AabbTree::Balance(const uint32_t a)
+    {
+        const Node& node = m_nodes[a];
+        if (node.IsLeaf() || node.height < 2)
+            return a;
+
+        const uint32_t b    = node.child_left;
+        const uint32_t c    = node.child_right;
+        const int32_t skew  = m_nodes[c].height - m_nodes[b].height;
+
+        // Rotates the child up, the child's shorter child is handed to a
+        const auto rotate = [this, a](const uint32_t child, const uint32_t child_other, const bool child_is_right)
+        {
+            Node& node_a        = m_nodes[a];
+            Node& node_child    = m_nodes[child];
+            const uint32_t f    = node_child.child_left;
+            const uint32_t g    = node_child.child_right;
+
+            // Swap a and the child
+            node_child.child_left   = a;
+            node_child.parent       = node_a.parent;
+            node_a.parent           = child;
+
+            // a's old parent should point to the child
+            if (node_child.parent != null)
+            {
+                if (m_nodes[node_child.parent].child_left == a)
+                {
+                    m_nodes[node_child.parent].child_left = child;
+                }
+                else
+                {
+                    m_nodes[node_child.parent].child_right = child;
+                }
+            }
+            else
+            {
+                m_root = child;
+            }
+
+            // The taller grandchild stays with the child, the shorter one moves to a
+            const bool f_taller         = m_nodes[f].height > m_nodes[g].height;
+            const uint32_t keep         = f_taller ? f : g;
+            const uint32_t give         = f_taller ? g : f;
+            node_child.child_right      = keep;
+            m_nodes[give].parent        = a;
+            if (child_is_right)
+            {
+                node_a.child_right = give;
+            }
+            else
+            {
+                node_a.child_left = give;
+            }
+
+            node_a.box          = merge(m_nodes[child_other].box, m_nodes[give].box);
+            node_a.height       = 1 + Helper::Max(m_nodes[child_other].height, m_nodes[give].height);
+            node_child.box      = merge(node_a.box, m_nodes[keep].box);
+            node_child.height   = 1 + Helper::Max(node_a.height, m_nodes[keep].height);
+        };
+
+        if (skew > 1)
+        {
+            rotate(c, b, true);
+            return c;
+        }
+
+        if (skew < -1)
+        {
+            rotate(b, c, false);
+            return b;
+        }
+
+        return a;
+    }
+}
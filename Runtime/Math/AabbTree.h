@@ -0,0 +1,220 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+//= INCLUDES ==========
+#include <vector>
+#include "BoundingBox.h"
+#include "Frustum.h"
+#include "Ray.h"
+//=====================
+
+namespace Spartan::Math
+{
+    // A dynamic bounding volume hierarchy. Every proxy is a leaf whose box is enlarged by a margin,
+    // so objects which move by less than the margin don't change the tree. Insertion picks the sibling
+    // with the least surface area cost and the tree is kept balanced with rotations, so queries only
+    // visit the branches which overlap them and their cost scales with the number of results.
+    class SPARTAN_CLASS AabbTree
+    {
+    public:
+        static constexpr uint32_t null = std::numeric_limits<uint32_t>::max();
+
+        AabbTree(float margin = 0.1f) { m_margin = margin; }
+        ~AabbTree() = default;
+
+        //= PROXIES ==================================================================================
+        uint32_t ProxyCreate(const BoundingBox& box, void* user_data);
+        void ProxyDestroy(uint32_t proxy);
+
+        // Returns true if the proxy left its enlarged box and had to be re-inserted
+        bool ProxyMove(uint32_t proxy, const BoundingBox& box);
+
+        void* ProxyGetUserData(const uint32_t proxy)            const { return m_nodes[proxy].user_data; }
+        const BoundingBox& ProxyGetBox(const uint32_t proxy)    const { return m_boxes_tight[proxy]; }
+        uint32_t GetProxyCount()                                const { return m_proxy_count; }
+        //============================================================================================
+
+        void Clear();
+        uint32_t GetHeight() const { return m_root == null ? 0 : m_nodes[m_root].height; }
+
+        //= QUERIES ==================================================================================
+        // Leaves are tested against their exact box, so only proxies which pass the test are reported.
+        // Branches which are entirely inside the query volume are reported without any further tests.
+
+        // Invokes function(void* user_data) for every proxy that overlaps the box
+        template <typename Function>
+        void QueryAabb(const BoundingBox& box, Function&& function) const
+        {
+            Traverse(
+                [&box](const BoundingBox& node_box) { return box.IsInside(node_box); },
+                [&function](const uint32_t, void* user_data) { function(user_data); }
+            );
+        }
+
+        // Invokes function(void* user_data) for every proxy that overlaps the sphere
+        template <typename Function>
+        void QuerySphere(const Vector3& center, const float radius, Function&& function) const
+        {
+            const float radius_squared = radius * radius;
+
+            Traverse(
+                [&center, radius_squared](const BoundingBox& node_box)
+                {
+                    const Vector3& min = node_box.GetMin();
+                    const Vector3& max = node_box.GetMax();
+
+                    const Vector3 closest = Vector3(Helper::Clamp(center.x, min.x, max.x), Helper::Clamp(center.y, min.y, max.y), Helper::Clamp(center.z, min.z, max.z));
+                    if ((closest - center).LengthSquared() > radius_squared)
+                        return Outside;
+
+                    const Vector3 farthest = Vector3(
+                        Helper::Max(Helper::Abs(min.x - center.x), Helper::Abs(max.x - center.x)),
+                        Helper::Max(Helper::Abs(min.y - center.y), Helper::Abs(max.y - center.y)),
+                        Helper::Max(Helper::Abs(min.z - center.z), Helper::Abs(max.z - center.z))
+                    );
+                    return farthest.LengthSquared() <= radius_squared ? Inside : Intersects;
+                },
+                [&function](const uint32_t, void* user_data) { function(user_data); }
+            );
+        }
+
+        // Invokes function(void* user_data) for every proxy that overlaps the frustum, the near plane can be ignored (for shadow casters)
+        template <typename Function>
+        void QueryFrustum(const Frustum& frustum, Function&& function, const bool ignore_near_plane = false) const
+        {
+            const uint32_t plane_first = ignore_near_plane ? 2 : 0;
+
+            Traverse(
+                [&frustum, plane_first](const BoundingBox& node_box)
+                {
+                    const Vector3 center    = node_box.GetCenter();
+                    const Vector3 extent    = node_box.GetExtents();
+                    Intersection result     = Inside;
+
+                    for (uint32_t i = plane_first; i < 6; i++)
+                    {
+                        const Plane& plane  = frustum.GetPlane(i);
+                        const float d       = center.Dot(plane.normal);
+                        const float r       = extent.Dot(plane.normal.Abs());
+
+                        if (d + r < -plane.d)
+                            return Outside;
+
+                        if (d - r < -plane.d)
+                        {
+                            result = Intersects;
+                        }
+                    }
+
+                    return result;
+                },
+                [&function](const uint32_t, void* user_data) { function(user_data); }
+            );
+        }
+
+        // Invokes function(void* user_data, float distance) for every proxy that the ray hits, in no particular order
+        template <typename Function>
+        void Raycast(const Ray& ray, Function&& function) const
+        {
+            Traverse(
+                [&ray](const BoundingBox& node_box) { return ray.HitDistance(node_box) != Helper::INFINITY_ ? Intersects : Outside; },
+                [this, &ray, &function](const uint32_t proxy, void* user_data) { function(user_data, ray.HitDistance(m_boxes_tight[proxy])); }
+            );
+        }
+        //============================================================================================
+
+    private:
+        struct Node
+        {
+            bool IsLeaf() const { return child_left == null; }
+
+            BoundingBox box;                // enlarged for leaves
+            void* user_data     = nullptr;
+            uint32_t parent     = null;     // next free node while the node is unused
+            uint32_t child_left = null;
+            uint32_t child_right= null;
+            int32_t height      = 0;        // 0 for leaves, -1 for free nodes
+        };
+
+        static constexpr uint32_t stack_size = 256;
+
+        // Visits the nodes for which test(box) isn't Outside, leaves are tested against their exact box before being reported
+        template <typename Test, typename Report>
+        void Traverse(Test&& test, Report&& report) const
+        {
+            if (m_root == null)
+                return;
+
+            // The depth of the stack never exceeds the height of the tree, which stays logarithmic as the tree is balanced.
+            // The top bit of an entry marks nodes whose parent was entirely inside, they don't need to be tested.
+            constexpr uint32_t inside_bit = 1u << 31;
+            uint32_t stack[stack_size];
+            uint32_t stack_count    = 0;
+            stack[stack_count++]    = m_root;
+
+            while (stack_count != 0)
+            {
+                const uint32_t entry    = stack[--stack_count];
+                const uint32_t index    = entry & ~inside_bit;
+                const Node& node        = m_nodes[index];
+
+                Intersection result = Inside;
+                if (!(entry & inside_bit))
+                {
+                    result = test(node.box);
+                    if (result == Outside)
+                        continue;
+                }
+
+                if (node.IsLeaf())
+                {
+                    if (result == Inside || test(m_boxes_tight[index]) != Outside)
+                    {
+                        report(index, node.user_data);
+                    }
+                }
+                else
+                {
+                    SP_ASSERT(stack_count + 2 <= stack_size);
+                    const uint32_t flag = result == Inside ? inside_bit : 0;
+                    stack[stack_count++] = node.child_left  | flag;
+                    stack[stack_count++] = node.child_right | flag;
+                }
+            }
+        }
+
+        uint32_t NodeAllocate();
+        void NodeFree(uint32_t index);
+        void LeafInsert(uint32_t leaf);
+        void LeafRemove(uint32_t leaf);
+        uint32_t Balance(uint32_t index);
+
+        std::vector<Node> m_nodes;
+        std::vector<BoundingBox> m_boxes_tight; // the exact box of each leaf, indexed like m_nodes
+        uint32_t m_root         = null;
+        uint32_t m_free_list    = null;
+        uint32_t m_proxy_count  = 0;
+        float m_margin          = 0.1f;
+    };
+}
@@ -0,0 +1,118 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= INCLUDES ==========
+#include "Spartan.h"
+#include "Histogram.h"
+#include <bit>
+//=====================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan
+{
+    void Histogram::AddSample(const float duration_ms)
+    {
+        m_buckets[GetBucket(duration_ms)]++;
+        m_count++;
+        m_max = Math::Helper::Max(m_max, duration_ms);
+    }
+
+    void Histogram::Merge(const Histogram& histogram)
+    {
+        for (uint32_t i = 0; i < bucket_count; i++)
+        {
+            m_buckets[i] += histogram.m_buckets[i];
+        }
+
+        m_count += histogram.m_count;
+        m_max   = Math::Helper::Max(m_max, histogram.m_max);
+    }
+
+    void Histogram::Clear()
+    {
+        m_buckets.fill(0);
+        m_count = 0;
+        m_max   = 0.0f;
+    }
+
+    float Histogram::GetPercentile(const float percentile) const
+    {
+        if (m_count == 0)
+            return 0.0f;
+
+        // The sample with this rank (1 based) is the percentile
+        const uint64_t rank = Math::Helper::Max<uint64_t>(static_cast<uint64_t>(ceil(Math::Helper::Clamp(percentile, 0.0f, 100.0f) / 100.0 * m_count)), 1);
+
+        uint64_t count = 0;
+        for (uint32_t i = 0; i < bucket_count; i++)
+        {
+            count += m_buckets[i];
+            if (count >= rank)
+                return Math::Helper::Min(GetBucketValue(i), m_max);
+        }
+
+        return m_max;
+    }
+
+    uint64_t Histogram::GetCountAbove(const float duration_ms) const
+    {
+        uint64_t count = 0;
+        for (uint32_t i = GetBucket(duration_ms) + 1; i < bucket_count; i++)
+        {
+            count += m_buckets[i];
+        }
+
+        return count;
+    }
+
+    uint32_t Histogram::GetBucket(const float duration_ms)
+    {
+        const uint32_t value_max = (1u << (exponent_max + 1)) - 1;
+        const uint32_t value     = static_cast<uint32_t>(Math::Helper::Clamp(duration_ms * 1000.0f, 0.0f, static_cast<float>(value_max)));
+
+        if (value < linear_count)
+            return value;
+
+        // The exponent selects a power of two range and the next sub_bucket_bits bits select a sub-bucket within it
+        const uint32_t exponent   = static_cast<uint32_t>(bit_width(value)) - 1;
+        const uint32_t sub_bucket = (value >> (exponent - sub_bucket_bits)) - sub_bucket_count;
+
+        return linear_count + (exponent - sub_bucket_bits - 1) * sub_bucket_count + sub_bucket;
+    }
+
+    float Histogram::GetBucketValue(const uint32_t bucket)
+    {
+        if (bucket < linear_count)
+            return (bucket + 0.5f) / 1000.0f;
+
+        // The middle of the bucket
+        const uint32_t exponent   = (bucket - linear_count) / sub_bucket_count + sub_bucket_bits + 1;
+        const uint32_t sub_bucket = (bucket - linear_count) % sub_bucket_count;
+        const uint32_t width      = 1u << (exponent - sub_bucket_bits);
+        const uint32_t start      = (sub_bucket_count + sub_bucket) * width;
+
+        return (start + width * 0.5f) / 1000.0f;
+    }
+}
@@ -0,0 +1,66 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+//= INCLUDES =====================
+#include <array>
+#include <cstdint>
+#include "../Core/Spartan_Definitions.h"
+//================================
+
+namespace Spartan
+{
+    // A fixed size, log-linear histogram of durations (in the spirit of an HDR histogram). Samples are bucketed
+    // in microseconds, with 32 sub-buckets per power of two, so percentiles are within ~3% of the true value,
+    // regardless of how many samples were added. Durations above ~2 minutes are clamped.
+    class SPARTAN_CLASS Histogram
+    {
+    public:
+        Histogram() { Clear(); }
+
+        void AddSample(float duration_ms);
+        void Merge(const Histogram& histogram);
+        void Clear();
+
+        // Percentile in the [0, 100] range, e.g. 99.9
+        float GetPercentile(float percentile) const;
+        // Number of samples which are longer than the given duration (e.g. hitches), to the precision of the buckets
+        uint64_t GetCountAbove(float duration_ms) const;
+        uint64_t GetCount() const   { return m_count; }
+        float GetMax()      const   { return m_max; }
+
+    private:
+        static constexpr uint32_t sub_bucket_bits   = 5;
+        static constexpr uint32_t sub_bucket_count  = 1 << sub_bucket_bits;
+        static constexpr uint32_t linear_count      = sub_bucket_count * 2;      // below this, every microsecond has its own bucket
+        static constexpr uint32_t exponent_max      = 26;                        // ~134 seconds
+        static constexpr uint32_t bucket_count      = linear_count + (exponent_max - sub_bucket_bits) * sub_bucket_count;
+
+        static uint32_t GetBucket(float duration_ms);
+        static float GetBucketValue(uint32_t bucket);
+
+        std::array<uint32_t, bucket_count> m_buckets;
+        uint64_t m_count    = 0;
+        float m_max         = 0.0f;
+    };
+}
@@ -21,9 +21,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES =========================
 #include "Spartan.h"
+#include <iomanip>
 #include "Profiler.h"
 #include "../Rendering/Renderer.h"
 #include "../Resource/ResourceCache.h"
+#include "../Threading/Threading.h"
 #include "../RHI/RHI_Device.h"
 #include "../RHI/RHI_CommandList.h"
 #include "../RHI/RHI_Implementation.h"
@@ -35,19 +37,183 @@ using namespace std;
 
 namespace Spartan
 {
+    // The time blocks of a single thread. Only the owning thread begins and ends blocks, and it publishes
+    // them once a whole tree (a root block and all of its children) is complete. The merge at the end of
+    // the frame consumes what was published, so neither side ever waits for the other.
+    struct TimeBlockBuffer
+    {
+        static constexpr uint64_t chunk_size  = 256;
+        static constexpr uint64_t chunk_count = 64;
+        static constexpr uint64_t capacity    = chunk_size * chunk_count;
+        static constexpr uint64_t invalid     = numeric_limits<uint64_t>::max();
+
+        TimeBlock& Get(const uint64_t index) { return chunks[(index / chunk_size) % chunk_count][index % chunk_size]; }
+
+        // Chunks are allocated when first written to, most threads never need more than one
+        array<unique_ptr<TimeBlock[]>, chunk_count> chunks;
+
+        // Owning thread only
+        vector<uint64_t> stack; // open blocks, invalid for blocks which were skipped
+        uint32_t open_count = 0;
+        uint64_t write      = 0;
+
+        atomic<uint64_t> published = 0;
+        atomic<uint64_t> consumed  = 0;
+
+        thread::id thread_id;
+        string thread_name;
+    };
+
+    // RHI counters which are written to traces
+    static constexpr array<pair<const char*, uint32_t Profiler::*>, 16> trace_rhi_counters =
+    {{
+        { "draw",                   &Profiler::m_rhi_draw },
+        { "dispatch",               &Profiler::m_rhi_dispatch },
+        { "buffer_index",           &Profiler::m_rhi_bindings_buffer_index },
+        { "buffer_vertex",          &Profiler::m_rhi_bindings_buffer_vertex },
+        { "buffer_constant",        &Profiler::m_rhi_bindings_buffer_constant },
+        { "sampler",                &Profiler::m_rhi_bindings_sampler },
+        { "texture_sampled",        &Profiler::m_rhi_bindings_texture_sampled },
+        { "texture_storage",        &Profiler::m_rhi_bindings_texture_storage },
+        { "shader_vertex",          &Profiler::m_rhi_bindings_shader_vertex },
+        { "shader_pixel",           &Profiler::m_rhi_bindings_shader_pixel },
+        { "shader_compute",         &Profiler::m_rhi_bindings_shader_compute },
+        { "render_target",          &Profiler::m_rhi_bindings_render_target },
+        { "descriptor_set",         &Profiler::m_rhi_bindings_descriptor_set },
+        { "pipeline",               &Profiler::m_rhi_bindings_pipeline },
+        { "pipeline_barriers",      &Profiler::m_rhi_pipeline_barriers },
+        { "meshes_rendered",        &Profiler::m_renderer_meshes_rendered }
+    }};
+
+    struct TraceFrame
+    {
+        uint64_t index = 0;
+        chrono::steady_clock::time_point end;
+        float time_frame = 0.0f;
+        float time_cpu   = 0.0f;
+        float time_gpu   = 0.0f;
+        array<uint32_t, trace_rhi_counters.size()> rhi_counters;
+        vector<TimeBlock> time_blocks;
+    };
+
+    static void write_json_string(ofstream& out, const char* text)
+    {
+        out << '"';
+        for (const char* c = text ? text : "unknown"; *c; c++)
+        {
+            if (*c == '"' || *c == '\\')
+            {
+                out << '\\';
+            }
+
+            if (static_cast<unsigned char>(*c) >= 0x20)
+            {
+                out << *c;
+            }
+        }
+        out << '"';
+    }
+
+    // Writes the frames in the Chrome trace event format, see https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+    static void write_trace(const vector<TraceFrame>& frames, const string& file_path)
+    {
+        ofstream out(file_path, ios::out | ios::trunc);
+        if (!out.good())
+        {
+            LOG_ERROR("Failed to open \"%s\" for writing", file_path.c_str());
+            return;
+        }
+
+        // Timestamps are in microseconds, relative to the earliest event
+        chrono::steady_clock::time_point epoch = frames.front().end;
+        for (const TraceFrame& frame : frames)
+        {
+            for (const TimeBlock& time_block : frame.time_blocks)
+            {
+                epoch = min<chrono::steady_clock::time_point>(epoch, time_block.GetStart());
+            }
+        }
+
+        const auto to_us = [&epoch](const chrono::steady_clock::time_point& time)
+        {
+            return chrono::duration<double, micro>(time - epoch).count();
+        };
+
+        out << fixed << setprecision(3);
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Spartan\"}},\n";
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"gpu\"}}";
+
+        // One track per thread, the GPU gets track 0
+        unordered_map<const char*, uint32_t> thread_tracks;
+        for (const TraceFrame& frame : frames)
+        {
+            for (const TimeBlock& time_block : frame.time_blocks)
+            {
+                uint32_t track = 0;
+                if (time_block.GetType() == TimeBlockType::Cpu)
+                {
+                    auto it = thread_tracks.find(time_block.GetThreadName());
+                    if (it == thread_tracks.end())
+                    {
+                        it = thread_tracks.emplace(time_block.GetThreadName(), static_cast<uint32_t>(thread_tracks.size()) + 1).first;
+
+                        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << it->second << ",\"args\":{\"name\":";
+                        write_json_string(out, it->first);
+                        out << "}}";
+                    }
+                    track = it->second;
+                }
+
+                out << ",\n{\"name\":";
+                write_json_string(out, time_block.GetName());
+                out << ",\"cat\":\"" << (track == 0 ? "gpu" : "cpu") << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << track;
+                out << ",\"ts\":" << to_us(time_block.GetStart()) << ",\"dur\":" << time_block.GetDuration() * 1000.0f << "}";
+            }
+
+            // Frame marker and counters, at the end of the frame
+            const double ts = to_us(frame.end);
+            out << ",\n{\"name\":\"Frame " << frame.index << "\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":" << ts << "}";
+            out << ",\n{\"name\":\"time_ms\",\"ph\":\"C\",\"pid\":1,\"ts\":" << ts << ",\"args\":{\"frame\":" << frame.time_frame << ",\"cpu\":" << frame.time_cpu << ",\"gpu\":" << frame.time_gpu << "}}";
+            out << ",\n{\"name\":\"rhi\",\"ph\":\"C\",\"pid\":1,\"ts\":" << ts << ",\"args\":{";
+            for (uint32_t i = 0; i < static_cast<uint32_t>(trace_rhi_counters.size()); i++)
+            {
+                out << (i == 0 ? "" : ",") << "\"" << trace_rhi_counters[i].first << "\":" << frame.rhi_counters[i];
+            }
+            out << "}}";
+        }
+
+        out << "\n]}\n";
+        out.close();
+
+        LOG_INFO("Trace of %d frames written to \"%s\"", static_cast<uint32_t>(frames.size()), file_path.c_str());
+    }
+
+    static thread_local TimeBlockBuffer* t_time_block_buffer      = nullptr;
+    static thread_local const Profiler* t_time_block_buffer_owner = nullptr;
+
     Profiler::Profiler(Context* context) : ISubsystem(context)
     {
-        m_time_blocks_read.reserve(m_time_block_capacity);
-        m_time_blocks_read.resize(m_time_block_capacity);
-        m_time_blocks_write.reserve(m_time_block_capacity);
-        m_time_blocks_write.resize(m_time_block_capacity);
+        m_time_blocks_read.reserve(200);
     }
 
     Profiler::~Profiler()
     {
-        if (m_poll) OnFrameEnd();
-        m_time_blocks_write.clear();
+        // Trace writes reference the thread names of the time block buffers
+        if (m_threading)
+        {
+            m_threading->Wait(m_trace_write_counter);
+        }
+
+        if (m_record) OnFrameEnd();
+
+        if (!m_statistics_report_path.empty())
+        {
+            FileSystem::CreateTextFile(m_statistics_report_path, GetStatisticsReport());
+        }
+
         m_time_blocks_read.clear();
+        m_time_block_buffers.clear();
         ClearRhiMetrics();
     }
 
@@ -56,6 +222,7 @@ namespace Spartan
         m_resource_manager    = m_context->GetSubsystem<ResourceCache>();
         m_renderer            = m_context->GetSubsystem<Renderer>();
         m_timer               = m_context->GetSubsystem<Timer>();
+        m_threading           = m_context->GetSubsystem<Threading>();
 
         return true;
     }
@@ -69,25 +236,10 @@ namespace Spartan
         if (!rhi_device || !rhi_device->GetContextRhi()->profiler)
             return;
 
-        if (m_increase_capacity)
+        const bool time_blocks_recorded = m_record;
+        if (time_blocks_recorded)
         {
             OnFrameEnd();
-
-            const uint32_t new_size = m_time_block_count + 100;
-            m_time_blocks_read.reserve(new_size);
-            m_time_blocks_read.resize(new_size);
-            m_time_blocks_write.reserve(new_size);
-            m_time_blocks_write.resize(new_size);
-            LOG_WARNING("Time block list has grown to fit %d commands. Consider making the capacity larger to avoid re-allocations.", m_time_block_count + 1);
-            m_increase_capacity = false;
-            m_poll = true;
-        }
-        else
-        {
-            if (m_profile && m_poll)
-            {
-                OnFrameEnd();
-            }
         }
 
         // Compute timings
@@ -108,7 +260,8 @@ namespace Spartan
                 if (!time_block.IsComplete())
                     continue;
 
-                if (!time_block.GetParent() && time_block.GetType() == TimeBlockType::Cpu)
+                // Blocks of other threads overlap with the frame, so only this thread's make up the CPU time
+                if (!time_block.GetParent() && time_block.GetType() == TimeBlockType::Cpu && time_block.GetThreadId() == this_thread::get_id())
                 {
                     m_time_cpu_last += time_block.GetDuration();
                 }
@@ -149,6 +302,14 @@ namespace Spartan
             }
         }
 
+        UpdateStatistics(delta_time, time_blocks_recorded);
+
+        // Capture the frame (if a trace is being captured)
+        if (m_record)
+        {
+            TraceAddFrame();
+        }
+
         // Check whether we should profile or not
         m_time_since_profiling_sec += delta_time;
         if (m_time_since_profiling_sec >= m_profiling_interval_sec)
@@ -171,23 +332,34 @@ namespace Spartan
             {
                 UpdateRhiMetricsString();
             }
+
+            // Task statistics are accumulated over the polling interval
+            m_threading->ResetStats();
         }
 
+        m_record = (m_profile && m_poll) || m_trace_frames_remaining != 0 || m_trace_on_stutter;
+
         ClearRhiMetrics();
     }
 
     void Profiler::OnFrameEnd()
     {
-        // Clear time blocks
+        // Merge the time blocks of all threads
         {
+            m_time_blocks_read.clear();
             uint32_t pass_index_gpu = 0;
 
-            for (uint32_t i = 0; i < m_time_block_count; i++)
+            lock_guard<mutex> lock(m_mutex_time_block_buffers);
+            for (const unique_ptr<TimeBlockBuffer>& buffer : m_time_block_buffers)
             {
-                TimeBlock& time_block = m_time_blocks_write[i];
+                // Blocks of trees which are still open are left for the next merge
+                const uint64_t published = buffer->published.load(memory_order_acquire);
+                const uint64_t consumed  = buffer->consumed.load(memory_order_relaxed);
 
-                if (time_block.IsComplete())
+                for (uint64_t i = consumed; i < published; i++)
                 {
+                    TimeBlock& time_block = buffer->Get(i);
+
                     // Must not happen when TimeBlockEnd() ends as D3D11 waits
                     // too much for the results to be ready, which increases CPU time.
                     time_block.ComputeDuration(pass_index_gpu);
@@ -196,49 +368,87 @@ namespace Spartan
                         pass_index_gpu += 2;
                     }
 
-                    m_time_blocks_read[i] = time_block;
-                }
-                else
-                {
-                    LOG_WARNING("TimeBlockEnd() was not called for time block \"%s\"", time_block.GetName());
+                    TimeBlock& time_block_read = m_time_blocks_read.emplace_back(time_block);
+                    time_block_read.SetThread(buffer->thread_id, buffer->thread_name.c_str());
+
+                    time_block.Reset();
                 }
-                
-                time_block.Reset();
-            }
 
-            m_time_block_count = 0;
+                // Hand the slots back to the owning thread
+                buffer->consumed.store(published, memory_order_release);
+            }
         }
     }
 
     void Profiler::TimeBlockStart(const char* func_name, TimeBlockType type, RHI_CommandList* cmd_list /*= nullptr*/)
     {
-        if (!m_profile || !m_poll)
-            return;
-
         const bool can_profile_cpu = (type == TimeBlockType::Cpu) && m_profile_cpu;
         const bool can_profile_gpu = (type == TimeBlockType::Gpu) && m_profile_gpu;
 
-        if (!can_profile_cpu && !can_profile_gpu)
+        if (!m_record || (!can_profile_cpu && !can_profile_gpu))
+        {
+            // Keep starts and ends balanced, polling can be toggled while blocks are open
+            if (t_time_block_buffer_owner == this)
+            {
+                t_time_block_buffer->stack.emplace_back(TimeBlockBuffer::invalid);
+            }
+
             return;
+        }
 
-        // Last incomplete block of the same type, is the parent
-        TimeBlock* time_block_parent = GetLastIncompleteTimeBlock(type);
+        TimeBlockBuffer* buffer = GetTimeBlockBuffer();
 
-        if (TimeBlock* time_block = GetNewTimeBlock())
+        // If the merge has fallen behind, drop the block
+        if (buffer->write - buffer->consumed.load(memory_order_acquire) >= TimeBlockBuffer::capacity)
         {
-            time_block->Begin(func_name, type, time_block_parent, cmd_list, m_renderer->GetRhiDevice());
+            buffer->stack.emplace_back(TimeBlockBuffer::invalid);
+            LOG_WARNING("The time block buffer of thread \"%s\" is full, make sure that TimeBlockEnd() is called for every TimeBlockStart()", buffer->thread_name.c_str());
+            return;
         }
+
+        // Last open block of the same type, is the parent
+        TimeBlock* time_block_parent = nullptr;
+        for (auto it = buffer->stack.rbegin(); it != buffer->stack.rend(); it++)
+        {
+            if (*it != TimeBlockBuffer::invalid && buffer->Get(*it).GetType() == type)
+            {
+                time_block_parent = &buffer->Get(*it);
+                break;
+            }
+        }
+
+        unique_ptr<TimeBlock[]>& chunk = buffer->chunks[(buffer->write / TimeBlockBuffer::chunk_size) % TimeBlockBuffer::chunk_count];
+        if (!chunk)
+        {
+            chunk = make_unique<TimeBlock[]>(TimeBlockBuffer::chunk_size);
+        }
+
+        buffer->Get(buffer->write).Begin(func_name, type, time_block_parent, cmd_list, m_renderer->GetRhiDevice());
+        buffer->stack.emplace_back(buffer->write++);
+        buffer->open_count++;
     }
 
     void Profiler::TimeBlockEnd()
     {
-        // If the capacity 
-        if (m_increase_capacity)
+        if (t_time_block_buffer_owner != this)
+            return;
+
+        TimeBlockBuffer* buffer = t_time_block_buffer;
+        if (buffer->stack.empty())
+            return;
+
+        const uint64_t index = buffer->stack.back();
+        buffer->stack.pop_back();
+
+        if (index == TimeBlockBuffer::invalid)
             return;
 
-        if (TimeBlock* time_block = GetLastIncompleteTimeBlock())
+        buffer->Get(index).End();
+
+        // Once no block is open, everything written so far forms complete trees and can be merged
+        if (--buffer->open_count == 0)
         {
-            time_block->End();
+            buffer->published.store(buffer->write, memory_order_release);
         }
     }
 
@@ -256,35 +466,195 @@ namespace Spartan
         m_time_gpu_min      = std::numeric_limits<float>::max();
         m_time_gpu_max      = std::numeric_limits<float>::lowest();
         m_time_gpu_last     = 0.0f;
+
+        m_statistics_frame.Clear();
+        m_statistics_cpu.Clear();
+        m_statistics_gpu.Clear();
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            m_statistics_time_blocks[i].clear();
+            m_statistics_time_blocks_lookup[i].clear();
+        }
+        m_statistics_window_elapsed_sec = 0.0f;
     }
 
-    TimeBlock* Profiler::GetNewTimeBlock()
+    string Profiler::GetStatisticsReport() const
     {
-        // Increase capacity if needed
-        if (m_time_block_count >= static_cast<uint32_t>(m_time_blocks_write.size()))
+        string report;
+        char line[256];
+
+        const auto add_line = [this, &report, &line](const char* name, const Histogram& histogram)
         {
-            m_increase_capacity = true;
-            return nullptr;
+            snprintf
+            (
+                line, sizeof(line), "%-40.40s %10llu %9.2f %9.2f %9.2f %9.2f %9.2f %9llu\n",
+                name,
+                static_cast<unsigned long long>(histogram.GetCount()),
+                histogram.GetPercentile(50.0f),
+                histogram.GetPercentile(90.0f),
+                histogram.GetPercentile(99.0f),
+                histogram.GetPercentile(99.9f),
+                histogram.GetMax(),
+                static_cast<unsigned long long>(histogram.GetCountAbove(m_hitch_threshold_ms))
+            );
+
+            report += line;
+        };
+
+        snprintf(line, sizeof(line), "%-40s %10s %9s %9s %9s %9s %9s %9s\n", "Durations (ms)", "count", "p50", "p90", "p99", "p99.9", "max", "hitches");
+        report += line;
+        add_line("Frame", m_statistics_frame.total);
+        add_line("CPU", m_statistics_cpu.total);
+        add_line("GPU", m_statistics_gpu.total);
+
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            for (const auto& [name, statistics] : m_statistics_time_blocks[i])
+            {
+                add_line((string(i == 0 ? "CPU: " : "GPU: ") + name).c_str(), statistics.total);
+            }
         }
 
-        // Return a time block
-        return &m_time_blocks_write[m_time_block_count++];
+        snprintf(line, sizeof(line), "\nHitch threshold: %.2f ms\n", m_hitch_threshold_ms);
+        report += line;
+
+        return report;
     }
 
-    TimeBlock* Profiler::GetLastIncompleteTimeBlock(TimeBlockType type /*= TimeBlock_Undefined*/)
+    void Profiler::UpdateStatistics(const float delta_time, const bool time_blocks_recorded)
     {
-        for (int i = m_time_block_count - 1; i >= 0; i--)
+        m_statistics_frame.AddSample(m_time_frame_last);
+
+        // The rest are only known for frames which recorded time blocks
+        if (time_blocks_recorded)
         {
-            TimeBlock& time_block = m_time_blocks_write[i];
+            m_statistics_cpu.AddSample(m_time_cpu_last);
+            m_statistics_gpu.AddSample(m_time_gpu_last);
 
-            if (type == time_block.GetType() || type == TimeBlockType::Undefined)
+            for (const TimeBlock& time_block : m_time_blocks_read)
             {
-                if (!time_block.IsComplete())
-                    return &time_block;
+                if (!time_block.IsComplete() || !time_block.GetName())
+                    continue;
+
+                const uint32_t i = time_block.GetType() == TimeBlockType::Gpu ? 1 : 0;
+                TimeStatistics*& statistics = m_statistics_time_blocks_lookup[i][time_block.GetName()];
+                if (!statistics)
+                {
+                    statistics = &m_statistics_time_blocks[i][time_block.GetName()];
+                }
+
+                statistics->AddSample(time_block.GetDuration());
+            }
+        }
+
+        // Windows
+        m_statistics_window_elapsed_sec += delta_time;
+        if (m_statistics_window_elapsed_sec >= m_statistics_window_sec)
+        {
+            m_statistics_window_elapsed_sec = 0.0f;
+
+            m_statistics_frame.EndWindow();
+            m_statistics_cpu.EndWindow();
+            m_statistics_gpu.EndWindow();
+            for (uint32_t i = 0; i < 2; i++)
+            {
+                for (auto& [name, statistics] : m_statistics_time_blocks[i])
+                {
+                    statistics.EndWindow();
+                }
+            }
+        }
+    }
+
+    void Profiler::TraceCapture(const uint32_t frame_count, const string& file_path)
+    {
+        if (frame_count == 0)
+            return;
+
+        m_trace_frames.clear();
+        m_trace_frames.reserve(frame_count);
+        m_trace_frames_remaining = frame_count;
+        m_trace_file_path        = file_path;
+    }
+
+    void Profiler::SetTraceCaptureOnStutter(const bool enabled, const uint32_t frame_count /*= 60*/, const string& file_path /*= "trace_stutter.json"*/)
+    {
+        m_trace_on_stutter          = enabled && frame_count != 0;
+        m_trace_frames_stutter      = frame_count;
+        m_trace_file_path_stutter   = file_path;
+
+        if (!IsTraceCapturing())
+        {
+            m_trace_frames.clear();
+        }
+    }
+
+    void Profiler::TraceAddFrame()
+    {
+        if (!IsTraceCapturing() && !m_trace_on_stutter)
+            return;
+
+        TraceFrame& frame   = m_trace_frames.emplace_back();
+        frame.index         = m_renderer->GetFrameNum();
+        frame.end           = chrono::steady_clock::now();
+        frame.time_frame    = m_time_frame_last;
+        frame.time_cpu      = m_time_cpu_last;
+        frame.time_gpu      = m_time_gpu_last;
+        frame.time_blocks   = m_time_blocks_read;
+        for (uint32_t i = 0; i < static_cast<uint32_t>(trace_rhi_counters.size()); i++)
+        {
+            frame.rhi_counters[i] = this->*trace_rhi_counters[i].second;
+        }
+
+        if (IsTraceCapturing())
+        {
+            if (--m_trace_frames_remaining == 0)
+            {
+                TraceWrite(m_trace_file_path);
             }
+
+            return;
         }
 
-        return nullptr;
+        // Rolling window, it's written out once it's full, so that it includes the frames that led to the stutter
+        if (m_trace_frames.size() > m_trace_frames_stutter)
+        {
+            m_trace_frames.erase(m_trace_frames.begin());
+        }
+
+        if (m_is_stuttering_cpu && m_trace_frames.size() == m_trace_frames_stutter)
+        {
+            TraceWrite(FileSystem::GetFilePathWithoutExtension(m_trace_file_path_stutter) + "_" + to_string(frame.index) + ".json");
+        }
+    }
+
+    void Profiler::TraceWrite(const string& file_path)
+    {
+        // Writing can take a while, so it's done in the background
+        m_threading->AddTaskBackground([frames = move(m_trace_frames), file_path]()
+        {
+            write_trace(frames, file_path);
+        }, &m_trace_write_counter);
+
+        m_trace_frames.clear();
+    }
+
+    TimeBlockBuffer* Profiler::GetTimeBlockBuffer()
+    {
+        // Each thread registers its buffer once
+        if (t_time_block_buffer_owner != this)
+        {
+            unique_ptr<TimeBlockBuffer> buffer = make_unique<TimeBlockBuffer>();
+            buffer->thread_id   = this_thread::get_id();
+            buffer->thread_name = m_threading ? m_threading->GetThreadName(buffer->thread_id) : "unknown";
+            buffer->stack.reserve(64);
+
+            lock_guard<mutex> lock(m_mutex_time_block_buffers);
+            t_time_block_buffer       = m_time_block_buffers.emplace_back(move(buffer)).get();
+            t_time_block_buffer_owner = this;
+        }
+
+        return t_time_block_buffer;
     }
 
     void Profiler::AcquireGpuData()
@@ -304,6 +674,9 @@ namespace Spartan
     {
         const auto texture_count    = m_resource_manager->GetResourceCount(ResourceType::Texture) + m_resource_manager->GetResourceCount(ResourceType::Texture2d) + m_resource_manager->GetResourceCount(ResourceType::TextureCube);
         const auto material_count   = m_resource_manager->GetResourceCount(ResourceType::Material);
+        const TaskStats tasks_critical      = m_threading->GetStats(TaskPriority::Critical);
+        const TaskStats tasks_normal        = m_threading->GetStats(TaskPriority::Normal);
+        const TaskStats tasks_background    = m_threading->GetStats(TaskPriority::Background);
 
         static const char* text =
             // Times
@@ -329,6 +702,12 @@ namespace Spartan
             "Textures:\t\t\t%d\n"
             "Materials:\t\t%d\n"
             "\n"
+            // Threading (queued, executed, avg/max wait)
+            "\t\t\tqueued\texecuted\twait avg\twait max\n"
+            "Tasks critical:\t%d\t\t%d\t\t%06.2f\t%06.2f ms\n"
+            "Tasks normal:\t%d\t\t%d\t\t%06.2f\t%06.2f ms\n"
+            "Tasks background:\t%d\t\t%d\t\t%06.2f\t%06.2f ms\n"
+            "\n"
             // RHI
             "Draw:\t\t\t%d\n"
             "Dispatch:\t\t\t%d\n"
@@ -346,7 +725,7 @@ namespace Spartan
             "Descriptor set:\t%d\n"
             "Pipeline barrier:\t%d";
 
-        static char buffer[2048];
+        static char buffer[4096];
         sprintf_s
         (
             buffer, text,
@@ -369,6 +748,11 @@ namespace Spartan
             texture_count,
             material_count,
 
+            // Threading
+            tasks_critical.queue_depth,     static_cast<uint32_t>(tasks_critical.executed),     tasks_critical.wait_time_avg_ms,    tasks_critical.wait_time_max_ms,
+            tasks_normal.queue_depth,       static_cast<uint32_t>(tasks_normal.executed),       tasks_normal.wait_time_avg_ms,      tasks_normal.wait_time_max_ms,
+            tasks_background.queue_depth,   static_cast<uint32_t>(tasks_background.executed),   tasks_background.wait_time_avg_ms,  tasks_background.wait_time_max_ms,
+
             // RHI
             m_rhi_draw,
             m_rhi_dispatch,
@@ -24,10 +24,17 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ===========================
 #include <string>
 #include <vector>
+#include <map>
+#include <unordered_map>
+#include <array>
+#include <mutex>
+#include <atomic>
 #include "TimeBlock.h"
+#include "Histogram.h"
 #include "../Core/ISubsystem.h"
 #include "../Core/Stopwatch.h"
 #include "../Core/Spartan_Definitions.h"
+#include "../Threading/Task.h"
 //======================================
 
 #define TIME_BLOCK_START_NAMED(profiler, name)  profiler->TimeBlockStart(name, Spartan::TimeBlockType::Cpu, nullptr);
@@ -40,8 +47,23 @@ namespace Spartan
     class Timer;
     class ResourceCache;
     class Renderer;
+    class Threading;
     class Variant;
     class Timer;
+    struct TimeBlockBuffer;
+    struct TraceFrame;
+
+    // Duration statistics of a frame, the CPU, the GPU or a time block
+    struct TimeStatistics
+    {
+        void AddSample(const float duration_ms) { total.AddSample(duration_ms); window_current.AddSample(duration_ms); }
+        void EndWindow()                        { window = window_current; window_current.Clear(); }
+        void Clear()                            { total.Clear(); window.Clear(); window_current.Clear(); }
+
+        Histogram total;            // since the last reset
+        Histogram window;           // the last complete window
+        Histogram window_current;
+    };
 
     class SPARTAN_CLASS Profiler : public ISubsystem
     {
@@ -74,6 +96,27 @@ namespace Spartan
         uint32_t GpuGetMemoryUsed()                     const { return m_gpu_memory_used; }
         bool IsCpuStuttering()                          const { return m_is_stuttering_cpu; }
         bool IsGpuStuttering()                          const { return m_is_stuttering_gpu; }
+
+        // Trace capture, writes the CPU blocks of all threads, the GPU blocks and the RHI counters of
+        // each frame to a Chrome trace file (JSON), which can be opened in chrome://tracing or Perfetto.
+        void TraceCapture(uint32_t frame_count, const std::string& file_path);
+        // Keeps a rolling window of the last frame_count frames and writes it out whenever the CPU stutters
+        void SetTraceCaptureOnStutter(bool enabled, uint32_t frame_count = 60, const std::string& file_path = "trace_stutter.json");
+        bool IsTraceCapturing()                         const { return m_trace_frames_remaining != 0; }
+        bool IsTraceCapturingOnStutter()                const { return m_trace_on_stutter; }
+
+        // Percentile statistics, time blocks are sampled on the frames they are recorded (see SetUpdateInterval())
+        const TimeStatistics& GetStatisticsFrame()      const { return m_statistics_frame; }
+        const TimeStatistics& GetStatisticsCpu()        const { return m_statistics_cpu; }
+        const TimeStatistics& GetStatisticsGpu()        const { return m_statistics_gpu; }
+        const std::map<std::string, TimeStatistics>& GetStatisticsTimeBlocks(TimeBlockType type) const { return m_statistics_time_blocks[type == TimeBlockType::Gpu]; }
+        float GetStatisticsWindow()                     const { return m_statistics_window_sec; }
+        void SetStatisticsWindow(const float seconds)         { m_statistics_window_sec = seconds; }
+        float GetHitchThreshold()                       const { return m_hitch_threshold_ms; }
+        void SetHitchThreshold(const float duration_ms)       { m_hitch_threshold_ms = duration_ms; }
+        // A report of the percentiles and hitch counts, it's written to the given file on shutdown (if any)
+        std::string GetStatisticsReport() const;
+        void SetStatisticsReportPath(const std::string& file_path) { m_statistics_report_path = file_path; }
         
         // Metrics - RHI
         uint32_t m_rhi_draw                     = 0;
@@ -130,22 +173,23 @@ namespace Spartan
             m_rhi_pipeline_barriers         = 0;
         }
 
-        TimeBlock* GetNewTimeBlock();
-        TimeBlock* GetLastIncompleteTimeBlock(TimeBlockType type = TimeBlockType::Undefined);
+        TimeBlockBuffer* GetTimeBlockBuffer();
         void AcquireGpuData();
         void UpdateRhiMetricsString();
+        void UpdateStatistics(float delta_time, bool time_blocks_recorded);
+        void TraceAddFrame();
+        void TraceWrite(const std::string& file_path);
 
         // Profiling options
-        bool m_profile                      = false;
+        std::atomic<bool> m_profile         = false;
         bool m_profile_cpu                  = true; // cheap
         bool m_profile_gpu                  = true; // expensive
         float m_profiling_interval_sec      = 0.3f;
         float m_time_since_profiling_sec    = m_profiling_interval_sec;
 
-        // Time blocks (double buffered)
-        uint32_t m_time_block_capacity  = 200;
-        uint32_t m_time_block_count     = 0;
-        std::vector<TimeBlock> m_time_blocks_write;
+        // Time blocks, recorded into one buffer per thread and merged into a single list at the end of the frame
+        std::vector<std::unique_ptr<TimeBlockBuffer>> m_time_block_buffers;
+        std::mutex m_mutex_time_block_buffers;
         std::vector<TimeBlock> m_time_blocks_read;
 
         // FPS
@@ -166,16 +210,36 @@ namespace Spartan
         bool m_is_stuttering_cpu    = false;
         bool m_is_stuttering_gpu    = false;
 
+        // Percentile statistics
+        TimeStatistics m_statistics_frame;
+        TimeStatistics m_statistics_cpu;
+        TimeStatistics m_statistics_gpu;
+        std::array<std::map<std::string, TimeStatistics>, 2> m_statistics_time_blocks;                  // cpu, gpu
+        std::array<std::unordered_map<const char*, TimeStatistics*>, 2> m_statistics_time_blocks_lookup; // by name pointer, to avoid string construction
+        float m_statistics_window_sec           = 10.0f;
+        float m_statistics_window_elapsed_sec   = 0.0f;
+        float m_hitch_threshold_ms              = 33.3f;
+        std::string m_statistics_report_path;
+
+        // Trace capture
+        std::vector<TraceFrame> m_trace_frames;
+        uint32_t m_trace_frames_remaining   = 0;
+        uint32_t m_trace_frames_stutter     = 0; // rolling window size
+        bool m_trace_on_stutter             = false;
+        std::string m_trace_file_path;
+        std::string m_trace_file_path_stutter;
+        TaskCounter m_trace_write_counter;
+
         // Misc
-        bool m_poll                 = false;
+        std::atomic<bool> m_poll    = false;
+        std::atomic<bool> m_record  = false; // time blocks are recorded when polling or capturing a trace
         std::string m_metrics       = "N/A";
-        bool m_increase_capacity    = 0.0f;
-        bool m_allow_time_block_end = true;
     
         // Dependencies
         ResourceCache* m_resource_manager   = nullptr;
         Renderer* m_renderer                = nullptr;
         Timer* m_timer                      = nullptr;
+        Threading* m_threading              = nullptr;
     };
 
     class ScopedTimeBlock
@@ -32,13 +32,31 @@ using namespace std;
 
 namespace Spartan
 {
-    uint32_t TimeBlock::m_max_tree_depth = 0;
+    atomic<uint32_t> TimeBlock::m_max_tree_depth = 0;
 
     TimeBlock::~TimeBlock()
     {
         Reset();
     }
 
+    TimeBlock& TimeBlock::operator=(const TimeBlock& time_block)
+    {
+        m_name          = time_block.m_name;
+        m_type          = time_block.m_type;
+        m_duration      = time_block.m_duration;
+        m_parent        = time_block.m_parent;
+        m_tree_depth    = time_block.m_tree_depth;
+        m_is_complete   = time_block.m_is_complete;
+        m_rhi_device    = time_block.m_rhi_device;
+        m_thread_id     = time_block.m_thread_id;
+        m_thread_name   = time_block.m_thread_name;
+        m_start         = time_block.m_start;
+        m_end           = time_block.m_end;
+        m_cmd_list      = time_block.m_cmd_list;
+
+        return *this;
+    }
+
     void TimeBlock::Begin(const char* name, TimeBlockType type, const TimeBlock* parent /*= nullptr*/, RHI_CommandList* cmd_list /*= nullptr*/, const shared_ptr<RHI_Device>& rhi_device /*= nullptr*/)
     {
         m_name                = name;
@@ -47,13 +65,14 @@ namespace Spartan
         m_rhi_device        = rhi_device.get();
         m_cmd_list          = cmd_list;
         m_type              = type;
-        m_max_tree_depth    = Math::Helper::Max(m_max_tree_depth, m_tree_depth);
 
-        if (type == TimeBlockType::Cpu)
-        {
-            m_start = chrono::high_resolution_clock::now();
-        }
-        else if (type == TimeBlockType::Gpu)
+        // Blocks can begin on any thread
+        uint32_t max_tree_depth = m_max_tree_depth.load(memory_order_relaxed);
+        while (max_tree_depth < m_tree_depth && !m_max_tree_depth.compare_exchange_weak(max_tree_depth, m_tree_depth, memory_order_relaxed)) {}
+
+        m_start = chrono::high_resolution_clock::now();
+
+        if (type == TimeBlockType::Gpu)
         {
             // Create required queries
             if (!m_query_disjoint)
@@ -24,6 +24,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =====================
 #include <chrono>
 #include <memory>
+#include <atomic>
+#include <thread>
 #include "..\RHI\RHI_Definition.h"
 //================================
 
@@ -44,6 +46,10 @@ namespace Spartan
         TimeBlock() = default;
         ~TimeBlock();
 
+        // Copies don't take the GPU queries, they remain owned (and released) by the block that created them
+        TimeBlock(const TimeBlock& time_block) { *this = time_block; }
+        TimeBlock& operator=(const TimeBlock& time_block);
+
         void Begin(const char* name, TimeBlockType type, const TimeBlock* parent = nullptr, RHI_CommandList* cmd_list = nullptr, const std::shared_ptr<RHI_Device>& rhi_device = nullptr);
         void End();
         void ComputeDuration(const uint32_t pass_index);
@@ -54,11 +60,17 @@ namespace Spartan
         uint32_t GetTreeDepth()         const { return m_tree_depth; }
         uint32_t GetTreeDepthMax()      const { return m_max_tree_depth; }
         float GetDuration()             const { return m_duration; }
+        const auto& GetStart()          const { return m_start; } // for GPU blocks, this is when the block was recorded
         bool IsComplete()               const { return m_is_complete; }
 
+        // The thread that recorded the block
+        void SetThread(const std::thread::id id, const char* name) { m_thread_id = id; m_thread_name = name; }
+        std::thread::id GetThreadId()   const { return m_thread_id; }
+        const char* GetThreadName()     const { return m_thread_name; }
+
     private:    
         static uint32_t FindTreeDepth(const TimeBlock* time_block, uint32_t depth = 0);
-        static uint32_t m_max_tree_depth;
+        static std::atomic<uint32_t> m_max_tree_depth;
 
         const char* m_name          = nullptr;
         TimeBlockType m_type        = TimeBlockType::Undefined;
@@ -67,6 +79,8 @@ namespace Spartan
         uint32_t m_tree_depth       = 0;
         bool m_is_complete          = false;
         RHI_Device* m_rhi_device    = nullptr;
+        std::thread::id m_thread_id;
+        const char* m_thread_name   = nullptr;
 
         // CPU timing
         std::chrono::steady_clock::time_point m_start;
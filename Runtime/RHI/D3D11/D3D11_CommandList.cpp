@@ -455,6 +455,22 @@ namespace Spartan
         return true;
     }
 
+    bool RHI_CommandList::DrawIndexedInstanced(const uint32_t index_count, const uint32_t instance_count, const uint32_t index_offset, const uint32_t vertex_offset)
+    {
+        m_rhi_device->GetContextRhi()->device_context->DrawIndexedInstanced
+        (
+            static_cast<UINT>(index_count),
+            static_cast<UINT>(instance_count),
+            static_cast<UINT>(index_offset),
+            static_cast<INT>(vertex_offset),
+            0
+        );
+
+        m_profiler->m_rhi_draw++;
+
+        return true;
+    }
+
     bool RHI_CommandList::Dispatch(uint32_t x, uint32_t y, uint32_t z, bool async /*= false*/)
     {
         ID3D11Device5* device = m_rhi_device->GetContextRhi()->device;
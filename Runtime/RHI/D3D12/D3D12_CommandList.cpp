@@ -113,6 +113,11 @@ namespace Spartan
     {
         return true;
     }
+
+    bool RHI_CommandList::DrawIndexedInstanced(const uint32_t index_count, const uint32_t instance_count, const uint32_t index_offset, const uint32_t vertex_offset)
+    {
+        return true;
+    }
     
     bool RHI_CommandList::Dispatch(uint32_t x, uint32_t y, uint32_t z, bool async /*= false*/)
     {
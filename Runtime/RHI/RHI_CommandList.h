@@ -73,6 +73,7 @@ namespace Spartan
         // Draw
         bool Draw(uint32_t vertex_count);
         bool DrawIndexed(uint32_t index_count, uint32_t index_offset = 0, uint32_t vertex_offset = 0);
+        bool DrawIndexedInstanced(uint32_t index_count, uint32_t instance_count, uint32_t index_offset = 0, uint32_t vertex_offset = 0);
         
         // Dispatch
         bool Dispatch(uint32_t x, uint32_t y, uint32_t z, bool async = false);
@@ -112,16 +112,16 @@ namespace Spartan
         m_context->GetSubsystem<Threading>()->AddTask([this, type, shader]()
         {
             Compile<T>(type, shader);
-        });
+        }, &m_compilation_task, TaskPriority::Background);
     }
 
     void RHI_Shader::WaitForCompilation()
     {
-        // Wait
-        while (m_compilation_state == Shader_Compilation_State::Compiling)
+        // Wait (this thread will help with any queued tasks in the meantime)
+        if (!m_compilation_task.IsDone())
         {
             LOG_INFO("Waiting for shader \"%s\" to compile...", m_name.c_str());
-            std::this_thread::sleep_for(std::chrono::milliseconds(16));
+            m_context->GetSubsystem<Threading>()->Wait(m_compilation_task);
         }
         
         // Log error in case of failure
@@ -27,6 +27,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <unordered_map>
 #include <vector>
 #include "../Core/Spartan_Object.h"
+#include "../Threading/Task.h"
 #include "RHI_Vertex.h"
 #include "RHI_Descriptor.h"
 //=================================
@@ -89,6 +90,7 @@ namespace Spartan
         std::atomic<Shader_Compilation_State> m_compilation_state   = Shader_Compilation_State::Idle;
         RHI_Shader_Type m_shader_type                               = RHI_Shader_Unknown;
         RHI_Vertex_Type m_vertex_type                               = RHI_Vertex_Type_Unknown;
+        TaskCounter m_compilation_task;
 
         // API 
         void* m_resource = nullptr;
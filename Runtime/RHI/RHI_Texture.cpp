@@ -110,9 +110,19 @@ namespace Spartan
     }
 
     bool RHI_Texture::LoadFromFile(const string& path)
+    {
+        return Load(path, nullptr);
+    }
+
+    bool RHI_Texture::LoadFromMemory(const string& path, vector<std::byte>&& data)
+    {
+        return Load(path, &data);
+    }
+
+    bool RHI_Texture::Load(const string& path, vector<std::byte>* data)
     {
         // Validate file path
-        if (!FileSystem::IsFile(path))
+        if (!data && !FileSystem::IsFile(path))
         {
             LOG_ERROR("\"%s\" is not a valid file path.", path.c_str());
             return false;
@@ -126,7 +136,9 @@ namespace Spartan
         auto texture_data_loaded = false;
         if (FileSystem::IsEngineTextureFile(path)) // engine format (binary)
         {
-            texture_data_loaded = LoadFromFile_NativeFormat(path);
+            // Read from the data we were given or map the file
+            auto file = data ? make_unique<FileStream>(move(*data)) : make_unique<FileStream>(path, FileStream_Read | FileStream_Mmap);
+            texture_data_loaded = file->IsOpen() && LoadFromFile_NativeFormat(file.get());
         }    
         else if (FileSystem::IsSupportedImageFile(path)) // foreign format (most known image formats)
         {
@@ -189,7 +201,7 @@ namespace Spartan
         return m_data[index];
     }
 
-    vector<std::byte> RHI_Texture::GetOrLoadMip(const uint8_t index)
+    vector<std::byte> RHI_Texture::GetOrLoadMip(const uint8_t index, vector<std::byte>* file_data /*= nullptr*/)
     {
         vector<std::byte> data;
 
@@ -201,7 +213,7 @@ namespace Spartan
         // Else attempt to load the data
         else
         {
-            auto file = make_unique<FileStream>(GetResourceFilePathNative(), FileStream_Read);
+            auto file = file_data ? make_unique<FileStream>(move(*file_data)) : make_unique<FileStream>(GetResourceFilePathNative(), FileStream_Read | FileStream_Mmap);
             if (file->IsOpen())
             {
                 auto byte_count = file->ReadAs<uint32_t>();
@@ -209,10 +221,14 @@ namespace Spartan
 
                 if (index < mip_count)
                 {
-                    for (uint8_t i = 0; i <= index; i++)
+                    // Skip over the preceding mips without copying them
+                    for (uint8_t i = 0; i < index; i++)
                     {
-                        file->Read(&data);
+                        file->ReadView();
                     }
+
+                    const span<const std::byte> mip = file->ReadView();
+                    data.assign(mip.begin(), mip.end());
                 }
                 else
                 {
@@ -242,12 +258,8 @@ namespace Spartan
         return true;
     }
 
-    bool RHI_Texture::LoadFromFile_NativeFormat(const string& file_path)
+    bool RHI_Texture::LoadFromFile_NativeFormat(FileStream* file)
     {
-        auto file = make_unique<FileStream>(file_path, FileStream_Read);
-        if (!file->IsOpen())
-            return false;
-
         m_data.clear();
         m_data.shrink_to_fit();
 
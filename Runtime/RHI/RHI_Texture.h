@@ -31,6 +31,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 namespace Spartan
 {
+    class FileStream;
+
     enum RHI_Texture_Flags : uint16_t
     {
         RHI_Texture_Sampled                    = 1 << 0,
@@ -59,6 +61,7 @@ namespace Spartan
         //= IResource ===========================================
         bool SaveToFile(const std::string& file_path) override;
         bool LoadFromFile(const std::string& file_path) override;
+        bool LoadFromMemory(const std::string& file_path, std::vector<std::byte>&& data) override;
         //=======================================================
 
         auto GetWidth() const                                           { return m_width; }
@@ -92,7 +95,8 @@ namespace Spartan
         std::vector<std::byte>& AddMip()                                { return m_data.emplace_back(std::vector<std::byte>()); }
         std::vector<std::vector<std::byte>>& GetMips()                  { return m_data; }
         std::vector<std::byte>& GetMip(const uint8_t mip_index);
-        std::vector<std::byte> GetOrLoadMip(const uint8_t mip_index);
+        // The contents of the file can be passed if they have already been read (e.g. with AwaitFileRead)
+        std::vector<std::byte> GetOrLoadMip(const uint8_t mip_index, std::vector<std::byte>* file_data = nullptr);
 
         // Binding type
         bool IsSampled()        const { return m_flags & RHI_Texture_Sampled; }
@@ -125,7 +129,8 @@ namespace Spartan
         void* Get_Resource_View_RenderTarget(const uint32_t i = 0)          const { return i < m_resource_view_renderTarget.size() ? m_resource_view_renderTarget[i] : nullptr; }
 
     protected:
-        bool LoadFromFile_NativeFormat(const std::string& file_path);
+        bool Load(const std::string& file_path, std::vector<std::byte>* data);
+        bool LoadFromFile_NativeFormat(FileStream* file);
         bool LoadFromFile_ForeignFormat(const std::string& file_path, bool generate_mipmaps);
         static uint32_t GetChannelCountFromFormat(RHI_Format format);
         virtual bool CreateResourceGpu() { LOG_ERROR("Function not implemented by API"); return false; }
@@ -458,6 +458,29 @@ namespace Spartan
         return true;
     }
 
+    bool RHI_CommandList::DrawIndexedInstanced(const uint32_t index_count, const uint32_t instance_count, const uint32_t index_offset, const uint32_t vertex_offset)
+    {
+        // Validate command list state
+        SP_ASSERT(m_state == RHI_CommandListState::Recording);
+
+        // Ensure correct state before attempting to draw
+        if (!OnDraw())
+            return false;
+
+        vkCmdDrawIndexed(
+            static_cast<VkCommandBuffer>(m_cmd_buffer), // commandBuffer
+            index_count,                                // indexCount
+            instance_count,                             // instanceCount
+            index_offset,                               // firstIndex
+            vertex_offset,                              // vertexOffset
+            0                                           // firstInstance
+        );
+
+        m_profiler->m_rhi_draw++;
+
+        return true;
+    }
+
     bool RHI_CommandList::Dispatch(uint32_t x, uint32_t y, uint32_t z, bool async /*= false*/)
     {
         // Validate command list state
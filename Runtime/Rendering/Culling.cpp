@@ -0,0 +1,224 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= INCLUDES =============================
+#include "Spartan.h"
+#include "Culling.h"
+#include "../World/Entity.h"
+#include "../World/Components/Renderable.h"
+#include "../Threading/Threading.h"
+#include <bit>
+#if defined(_M_X64) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define SP_CULLING_SSE
+#endif
+//========================================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace Spartan::Math;
+//============================
+
+namespace Spartan
+{
+    // Objects per visibility word, the bounding box arrays are padded to a multiple of this
+    static const uint32_t objects_per_word = 32;
+
+    // Objects per task
+    static const uint32_t words_per_task = 32;
+
+    void Culling::SetObjects(const vector<Entity*>& entities, Threading* threading)
+    {
+        Resize(static_cast<uint32_t>(entities.size()));
+
+        // Bounding boxes are updated lazily, each renderable updates its own
+        threading->AddTaskLoop([this, &entities](const uint32_t start, const uint32_t end)
+        {
+            for (uint32_t i = start; i < end; i++)
+            {
+                SetObject(i, entities[i]->GetRenderable()->GetAabb());
+            }
+        }, m_object_count);
+    }
+
+    uint32_t Culling::AddView(const Frustum& frustum, const bool ignore_near_plane /*= false*/)
+    {
+        if (m_view_count == m_views.size())
+        {
+            m_views.emplace_back();
+        }
+
+        View& view = m_views[m_view_count];
+
+        // Ignoring the near plane, ensures that shadow casters behind it are not rejected. Which one of the near
+        // and far planes is the near one depends on the depth (reverse-z or not), so both are skipped, this
+        // is fine since casters beyond the far plane are not rasterized anyway.
+        view.plane_count = 0;
+        for (uint32_t i = ignore_near_plane ? 2 : 0; i < 6; i++)
+        {
+            const Plane& plane      = frustum.GetPlane(i);
+            float* splat            = view.planes[view.plane_count++];
+            splat[0]                = plane.normal.x;
+            splat[1]                = plane.normal.y;
+            splat[2]                = plane.normal.z;
+            splat[3]                = Helper::Abs(plane.normal.x);
+            splat[4]                = Helper::Abs(plane.normal.y);
+            splat[5]                = Helper::Abs(plane.normal.z);
+            splat[6]                = plane.d;
+        }
+
+        return m_view_count++;
+    }
+
+    void Culling::Cull(Threading* threading)
+    {
+        const uint32_t word_count = (m_object_count + objects_per_word - 1) / objects_per_word;
+        const uint32_t task_count = (word_count + words_per_task - 1) / words_per_task;
+
+        for (uint32_t i = 0; i < m_view_count; i++)
+        {
+            m_views[i].visibility.resize(word_count);
+        }
+
+        // Test every range of objects against every view, each task writes whole words, so they never overlap
+        threading->AddTaskLoop([this, word_count, task_count](const uint32_t start, const uint32_t end)
+        {
+            for (uint32_t i = start; i < end; i++)
+            {
+                const uint32_t task = i % task_count;
+                CullRange(m_views[i / task_count], task * words_per_task, Helper::Min((task + 1) * words_per_task, word_count));
+            }
+        }, m_view_count * task_count);
+
+        // Compact the visibility bits into lists of indices
+        threading->AddTaskLoop([this, word_count](const uint32_t start, const uint32_t end)
+        {
+            for (uint32_t i = start; i < end; i++)
+            {
+                View& view = m_views[i];
+                view.visible.clear();
+
+                for (uint32_t word_index = 0; word_index < word_count; word_index++)
+                {
+                    uint32_t word = view.visibility[word_index];
+                    while (word != 0)
+                    {
+                        const uint32_t index = word_index * objects_per_word + static_cast<uint32_t>(countr_zero(word));
+                        if (index >= m_object_count)
+                            break;
+
+                        view.visible.emplace_back(index);
+                        word &= word - 1;
+                    }
+                }
+            }
+        }, m_view_count, 1);
+    }
+
+    void Culling::Resize(const uint32_t count)
+    {
+        m_object_count = count;
+
+        // Padding is zeroed, the compaction ignores it
+        const uint32_t count_padded = (count + objects_per_word - 1) / objects_per_word * objects_per_word;
+        for (vector<float>* values : { &m_center_x, &m_center_y, &m_center_z, &m_extent_x, &m_extent_y, &m_extent_z })
+        {
+            values->resize(count_padded);
+            fill(values->begin() + count, values->end(), 0.0f);
+        }
+    }
+
+    void Culling::SetObject(const uint32_t index, const BoundingBox& box)
+    {
+        const Vector3 center    = box.GetCenter();
+        const Vector3 extents   = box.GetExtents();
+
+        m_center_x[index] = center.x;
+        m_center_y[index] = center.y;
+        m_center_z[index] = center.z;
+        m_extent_x[index] = extents.x;
+        m_extent_y[index] = extents.y;
+        m_extent_z[index] = extents.z;
+    }
+
+    void Culling::CullRange(View& view, const uint32_t word_start, const uint32_t word_end) const
+    {
+        // A box is outside if it's entirely behind any of the planes, that is, if the distance of
+        // its center to the plane, plus its extents projected onto the plane normal, is negative.
+        for (uint32_t word_index = word_start; word_index < word_end; word_index++)
+        {
+            uint32_t word = 0;
+
+#if defined(SP_CULLING_SSE)
+            for (uint32_t lane = 0; lane < objects_per_word; lane += 4)
+            {
+                const uint32_t i = word_index * objects_per_word + lane;
+
+                const __m128 center_x = _mm_loadu_ps(&m_center_x[i]);
+                const __m128 center_y = _mm_loadu_ps(&m_center_y[i]);
+                const __m128 center_z = _mm_loadu_ps(&m_center_z[i]);
+                const __m128 extent_x = _mm_loadu_ps(&m_extent_x[i]);
+                const __m128 extent_y = _mm_loadu_ps(&m_extent_y[i]);
+                const __m128 extent_z = _mm_loadu_ps(&m_extent_z[i]);
+
+                __m128 outside = _mm_setzero_ps();
+                for (uint32_t p = 0; p < view.plane_count; p++)
+                {
+                    const float* plane = view.planes[p];
+
+                    __m128 distance = _mm_add_ps(_mm_mul_ps(center_x, _mm_set1_ps(plane[0])), _mm_set1_ps(plane[6]));
+                    distance        = _mm_add_ps(distance, _mm_mul_ps(center_y, _mm_set1_ps(plane[1])));
+                    distance        = _mm_add_ps(distance, _mm_mul_ps(center_z, _mm_set1_ps(plane[2])));
+                    distance        = _mm_add_ps(distance, _mm_mul_ps(extent_x, _mm_set1_ps(plane[3])));
+                    distance        = _mm_add_ps(distance, _mm_mul_ps(extent_y, _mm_set1_ps(plane[4])));
+                    distance        = _mm_add_ps(distance, _mm_mul_ps(extent_z, _mm_set1_ps(plane[5])));
+
+                    outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, _mm_setzero_ps()));
+                }
+
+                word |= static_cast<uint32_t>(~_mm_movemask_ps(outside) & 0xF) << lane;
+            }
+#else
+            for (uint32_t lane = 0; lane < objects_per_word; lane++)
+            {
+                const uint32_t i = word_index * objects_per_word + lane;
+
+                bool outside = false;
+                for (uint32_t p = 0; p < view.plane_count && !outside; p++)
+                {
+                    const float* plane = view.planes[p];
+
+                    const float distance =
+                        m_center_x[i] * plane[0] + m_center_y[i] * plane[1] + m_center_z[i] * plane[2] + plane[6] +
+                        m_extent_x[i] * plane[3] + m_extent_y[i] * plane[4] + m_extent_z[i] * plane[5];
+
+                    outside = distance < 0.0f;
+                }
+
+                word |= static_cast<uint32_t>(!outside) << lane;
+            }
+#endif
+
+            view.visibility[word_index] = word;
+        }
+    }
+}
@@ -0,0 +1,86 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+//= INCLUDES ======================
+#include <vector>
+#include <cstdint>
+#include "../Math/Frustum.h"
+#include "../Math/BoundingBox.h"
+#include "../Core/Spartan_Definitions.h"
+//=================================
+
+namespace Spartan
+{
+    class Entity;
+    class Threading;
+
+    // Tests the world space bounding boxes of a list of entities against any number of views (frustums).
+    // The boxes are stored as a structure of arrays, so that they can be tested 4 at a time (SSE), and
+    // all views are tested in parallel. The output is a compact (ascending) list of visible indices per view.
+    class SPARTAN_CLASS Culling
+    {
+    public:
+        // Gathers the bounding boxes of the entities (which must have a renderable)
+        void SetObjects(const std::vector<Entity*>& entities, Threading* threading);
+        uint32_t GetObjectCount() const { return m_object_count; }
+
+        // Views
+        void ClearViews() { m_view_count = 0; }
+        uint32_t AddView(const Math::Frustum& frustum, bool ignore_near_plane = false);
+        uint32_t GetViewCount() const { return m_view_count; }
+
+        // Tests all the objects against all the views
+        void Cull(Threading* threading);
+
+        // Indices (into the entities given to SetObjects()) of the objects which are visible from a view
+        const std::vector<uint32_t>& GetVisible(const uint32_t view) const { return m_views[view].visible; }
+
+    private:
+        struct View
+        {
+            // Planes as splats of (normal.x, normal.y, normal.z, abs(normal.x), abs(normal.y), abs(normal.z), d)
+            float planes[6][7];
+            uint32_t plane_count = 0;
+            std::vector<uint32_t> visibility; // one bit per object
+            std::vector<uint32_t> visible;
+        };
+
+        void Resize(uint32_t count);
+        void SetObject(uint32_t index, const Math::BoundingBox& box);
+        void CullRange(View& view, uint32_t word_start, uint32_t word_end) const;
+
+        // Bounding boxes as centers and extents, padded to a multiple of 32 (one visibility word)
+        std::vector<float> m_center_x;
+        std::vector<float> m_center_y;
+        std::vector<float> m_center_z;
+        std::vector<float> m_extent_x;
+        std::vector<float> m_extent_y;
+        std::vector<float> m_extent_z;
+        uint32_t m_object_count = 0;
+
+        // Views are kept between frames so that their lists don't re-allocate
+        std::vector<View> m_views;
+        uint32_t m_view_count = 0;
+    };
+}
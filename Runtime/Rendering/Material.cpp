@@ -28,7 +28,6 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../IO/XmlDocument.h"
 #include "../RHI/RHI_Texture2D.h"
 #include "../RHI/RHI_TextureCube.h"
-#include "../World/World.h"
 //====================================
 
 //= NAMESPACES ===============
@@ -38,6 +37,18 @@ using namespace Spartan::Math;
 
 namespace Spartan
 {
+    // What a texture which is still loading is substituted with, it should look like a texture-less material
+    static RHI_Texture* get_placeholder(Renderer* renderer, const Material_Property type)
+    {
+        if (type == Material_Normal)
+            return renderer->GetDefaultTextureNormal();
+
+        if (type == Material_Height || type == Material_Emission)
+            return renderer->GetDefaultTextureBlack();
+
+        return renderer->GetDefaultTextureWhite();
+    }
+
     Material::Material(Context* context) : IResource(context, ResourceType::Material)
     {
         m_rhi_device = context->GetSubsystem<Renderer>()->GetRhiDevice();
@@ -67,16 +78,16 @@ namespace Spartan
         SetResourceFilePath(file_path);
 
         xml->GetAttribute("Material", "Color",                          &m_color_albedo);
-        xml->GetAttribute("Material", "Roughness_Multiplier",           &GetProperty(Material_Roughness));
-        xml->GetAttribute("Material", "Metallic_Multiplier",            &GetProperty(Material_Metallic));
-        xml->GetAttribute("Material", "Normal_Multiplier",              &GetProperty(Material_Normal));
-        xml->GetAttribute("Material", "Height_Multiplier",              &GetProperty(Material_Height));
-        xml->GetAttribute("Material", "Clearcoat_Multiplier",           &GetProperty(Material_Clearcoat));
-        xml->GetAttribute("Material", "Clearcoat_Roughness_Multiplier", &GetProperty(Material_Clearcoat_Roughness));
-        xml->GetAttribute("Material", "Anisotropi_Multiplier",          &GetProperty(Material_Anisotropic));
-        xml->GetAttribute("Material", "Anisotropic_Rotatio_Multiplier", &GetProperty(Material_Anisotropic_Rotation));
-        xml->GetAttribute("Material", "Sheen_Multiplier",               &GetProperty(Material_Sheen));
-        xml->GetAttribute("Material", "Sheen_Tint_Multiplier",          &GetProperty(Material_Sheen_Tint));
+        xml->GetAttribute("Material", "Roughness_Multiplier",           &m_properties[Material_Roughness]);
+        xml->GetAttribute("Material", "Metallic_Multiplier",            &m_properties[Material_Metallic]);
+        xml->GetAttribute("Material", "Normal_Multiplier",              &m_properties[Material_Normal]);
+        xml->GetAttribute("Material", "Height_Multiplier",              &m_properties[Material_Height]);
+        xml->GetAttribute("Material", "Clearcoat_Multiplier",           &m_properties[Material_Clearcoat]);
+        xml->GetAttribute("Material", "Clearcoat_Roughness_Multiplier", &m_properties[Material_Clearcoat_Roughness]);
+        xml->GetAttribute("Material", "Anisotropi_Multiplier",          &m_properties[Material_Anisotropic]);
+        xml->GetAttribute("Material", "Anisotropic_Rotatio_Multiplier", &m_properties[Material_Anisotropic_Rotation]);
+        xml->GetAttribute("Material", "Sheen_Multiplier",               &m_properties[Material_Sheen]);
+        xml->GetAttribute("Material", "Sheen_Tint_Multiplier",          &m_properties[Material_Sheen_Tint]);
         xml->GetAttribute("Material", "IsEditable",                     &m_is_editable);
         xml->GetAttribute("Material", "UV_Tiling",                      &m_uv_tiling);
         xml->GetAttribute("Material", "UV_Offset",                      &m_uv_offset);
@@ -90,13 +101,23 @@ namespace Spartan
             auto tex_path                        = xml->GetAttributeAs<string>(node_name, "Texture_Path");
 
             // If the texture happens to be loaded, get a reference to it
-            auto texture = m_context->GetSubsystem<ResourceCache>()->GetByName<RHI_Texture2D>(tex_name);
-            // If there is not texture (it's not loaded yet), load it
-            if (!texture)
+            ResourceCache* resource_cache = m_context->GetSubsystem<ResourceCache>();
+            if (auto texture = resource_cache->GetByName<RHI_Texture2D>(tex_name))
             {
-                texture = m_context->GetSubsystem<ResourceCache>()->Load<RHI_Texture2D>(tex_path);
+                SetTextureSlot(tex_type, texture, GetProperty(tex_type));
+                continue;
             }
-            SetTextureSlot(tex_type, texture, GetProperty(tex_type));
+
+            // If there is not texture (it's not loaded yet), load it in the background, a placeholder is rendered until then
+            if (!FileSystem::Exists(tex_path))
+            {
+                LOG_ERROR("\"%s\" doesn't exist.", tex_path.c_str());
+                continue;
+            }
+
+            RHI_Texture2D* placeholder = static_cast<RHI_Texture2D*>(get_placeholder(m_context->GetSubsystem<Renderer>(), tex_type));
+            m_textures_loading[tex_type] = { resource_cache->LoadAsync<RHI_Texture2D>(tex_path, TaskPriority::Background, placeholder), tex_path };
+            m_flags |= tex_type;
         }
 
         // Ensure an a suitable shader exists
@@ -129,7 +150,7 @@ namespace Spartan
         xml->AddAttribute("Material", "IsEditable",                        m_is_editable);
 
         xml->AddChildNode("Material", "Textures");
-        xml->AddAttribute("Textures", "Count", static_cast<uint32_t>(m_textures.size()));
+        xml->AddAttribute("Textures", "Count", static_cast<uint32_t>(m_textures.size() + m_textures_loading.size()));
         auto i = 0;
         for (const auto& texture : m_textures)
         {
@@ -141,11 +162,25 @@ namespace Spartan
             i++;
         }
 
+        // Textures which haven't loaded yet are saved by path, like they were read
+        for (const auto& texture : m_textures_loading)
+        {
+            auto tex_node = "Texture_" + to_string(i);
+            xml->AddChildNode("Textures", tex_node);
+            xml->AddAttribute(tex_node, "Texture_Type", static_cast<uint32_t>(texture.first));
+            xml->AddAttribute(tex_node, "Texture_Name", FileSystem::GetFileNameNoExtensionFromFilePath(texture.second.file_path));
+            xml->AddAttribute(tex_node, "Texture_Path", texture.second.file_path);
+            i++;
+        }
+
         return xml->Save(GetResourceFilePathNative());
     }
 
     void Material::SetTextureSlot(const Material_Property type, const shared_ptr<RHI_Texture>& texture, float multiplier /*= 1.0f*/)
     {
+        // An explicitly set texture replaces one which is still loading
+        m_textures_loading.erase(type);
+
         if (texture)
         {
             // In order for the material to guarantee serialization/deserialization we cache the texture
@@ -163,6 +198,8 @@ namespace Spartan
 
         // Ensure an a suitable shader exists
         ShaderGBuffer::GenerateVariation(m_context, m_flags);
+
+        m_is_modified = true;
     }
 
     void Material::SetTextureSlot(const Material_Property type, const std::shared_ptr<RHI_Texture2D>& texture)
@@ -186,6 +223,12 @@ namespace Spartan
                 return true;
         }
 
+        for (const auto& texture : m_textures_loading)
+        {
+            if (texture.second.file_path == path)
+                return true;
+        }
+
         return false;
     }
 
@@ -194,6 +237,10 @@ namespace Spartan
         if (!HasTexture(type))
             return "";
 
+        const auto it = m_textures_loading.find(type);
+        if (it != m_textures_loading.end())
+            return it->second.file_path;
+
         return m_textures.at(type)->GetResourceFilePathNative();
     }
 
@@ -208,24 +255,73 @@ namespace Spartan
             paths.emplace_back(texture.second->GetResourceFilePathNative());
         }
 
+        for (const auto& texture : m_textures_loading)
+        {
+            paths.emplace_back(texture.second.file_path);
+        }
+
         return paths;
     }
 
+    RHI_Texture* Material::GetTexture_Ptr(const Material_Property type)
+    {
+        if (!HasTexture(type))
+            return nullptr;
+
+        const auto it = m_textures_loading.find(type);
+        if (it != m_textures_loading.end())
+        {
+            const LoadState state = it->second.handle.GetLoadState();
+
+            if (state == LoadState::Completed)
+            {
+                // The resource cache already holds it, so it can be swapped in without marking the material as modified
+                m_textures[type] = it->second.handle.GetResource();
+                m_textures_loading.erase(it);
+            }
+            else if (state == LoadState::Failed)
+            {
+                LOG_ERROR("Failed to load \"%s\".", it->second.file_path.c_str());
+                SetTextureSlot(type, shared_ptr<RHI_Texture>());
+                return nullptr;
+            }
+            else
+            {
+                return it->second.handle.Get();
+            }
+        }
+
+        return m_textures[type].get();
+    }
+
     shared_ptr<Spartan::RHI_Texture>& Material::GetTexture_PtrShared(const Material_Property type)
     {
         static shared_ptr<RHI_Texture> texture_empty;
-        return HasTexture(type) ? m_textures.at(type) : texture_empty;
+
+        // Resolve any texture which has finished loading
+        GetTexture_Ptr(type);
+
+        return (HasTexture(type) && m_textures.count(type)) ? m_textures.at(type) : texture_empty;
+    }
+
+    void Material::PrioritizeTextures(const TaskPriority priority)
+    {
+        for (auto& texture : m_textures_loading)
+        {
+            texture.second.handle.Prioritize(priority);
+        }
     }
 
     void Material::SetColorAlbedo(const Math::Vector4& color)
     {
-        // If an object switches from opaque to transparent or vice versa, make the world update so that the renderer
+        // If an object switches from opaque to transparent or vice versa, let the renderer know so that it
         // goes through the entities and makes the ones that use this material, render in the correct mode.
         if ((m_color_albedo.w != 1.0f && color.w == 1.0f) || (m_color_albedo.w == 1.0f && color.w != 1.0f))
         {
-            m_context->GetSubsystem<World>()->Resolve();
+            m_context->GetSubsystem<Renderer>()->RenderablesReclassify();
         }
 
-        m_color_albedo = color;
+        m_color_albedo  = color;
+        m_is_modified   = true;
     }
 }
@@ -26,6 +26,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <unordered_map>
 #include "../RHI/RHI_Definition.h"
 #include "../Resource/IResource.h"
+#include "../Resource/ResourceCache.h"
 #include "../Math/Vector2.h"
 #include "../Math/Vector4.h"
 //=================================
@@ -71,8 +72,11 @@ namespace Spartan
         bool HasTexture(const Material_Property type) const { return m_flags & type; }
         std::string GetTexturePathByType(Material_Property type);
         std::vector<std::string> GetTexturePaths();
-        RHI_Texture* GetTexture_Ptr(const Material_Property type) { return HasTexture(type) ? m_textures[type].get() : nullptr; }
+        RHI_Texture* GetTexture_Ptr(Material_Property type);
         std::shared_ptr<RHI_Texture>& GetTexture_PtrShared(const Material_Property type);
+
+        // Raises the priority of any textures which are still loading, called by the renderer when the material is visible
+        void PrioritizeTextures(TaskPriority priority);
         //=======================================================================================================================
         
         //= PROPERTIES =====================================================================================
@@ -80,16 +84,16 @@ namespace Spartan
         void SetColorAlbedo(const Math::Vector4& color);
 
         const Math::Vector2& GetTiling()                                    const { return m_uv_tiling; }
-        void SetTiling(const Math::Vector2& tiling)                         { m_uv_tiling = tiling; }
+        void SetTiling(const Math::Vector2& tiling)                         { m_uv_tiling = tiling; m_is_modified = true; }
 
         const Math::Vector2& GetOffset()                                    const { return m_uv_offset; }
-        void SetOffset(const Math::Vector2& offset)                         { m_uv_offset = offset; }
+        void SetOffset(const Math::Vector2& offset)                         { m_uv_offset = offset; m_is_modified = true; }
 
         auto IsEditable()                                                   const { return m_is_editable; }
-        void SetIsEditable(const bool is_editable)                          { m_is_editable = is_editable; }
+        void SetIsEditable(const bool is_editable)                          { m_is_editable = is_editable; m_is_modified = true; }
 
-        auto& GetProperty(const Material_Property type)                     { return m_properties[type]; }
-        void SetProperty(const Material_Property type, const float value)   { m_properties[type] = value; }
+        float GetProperty(const Material_Property type)                     const { const auto it = m_properties.find(type); return it != m_properties.end() ? it->second : 0.0f; }
+        void SetProperty(const Material_Property type, const float value)   { m_properties[type] = value; m_is_modified = true; }
 
         uint16_t GetFlags()                                                 const { return m_flags; }
         //==================================================================================================
@@ -101,6 +105,14 @@ namespace Spartan
         bool m_is_editable                = true;
         uint16_t m_flags                = 0;
         std::unordered_map<Material_Property, std::shared_ptr<RHI_Texture>> m_textures;
+
+        // Textures which are loading asynchronously, a placeholder is returned in their place until they are moved to m_textures
+        struct TextureLoading
+        {
+            ResourceHandle<RHI_Texture2D> handle;
+            std::string file_path;
+        };
+        std::unordered_map<Material_Property, TextureLoading> m_textures_loading;
         std::unordered_map<Material_Property, float> m_properties;
         std::shared_ptr<RHI_Device> m_rhi_device;
     };
@@ -65,9 +65,20 @@ namespace Spartan
         m_aabb.Undefine();
         m_normalized_scale = 1.0f;
         m_is_animated = false;
+        m_is_modified = true;
     }
 
     bool Model::LoadFromFile(const string& file_path)
+    {
+        return Load(file_path, nullptr);
+    }
+
+    bool Model::LoadFromMemory(const string& file_path, vector<std::byte>&& data)
+    {
+        return Load(file_path, &data);
+    }
+
+    bool Model::Load(const string& file_path, vector<std::byte>* data)
     {
         const Stopwatch timer;
 
@@ -80,8 +91,8 @@ namespace Spartan
         // Load engine format
         if (FileSystem::GetExtensionFromFilePath(file_path) == EXTENSION_MODEL)
         {
-            // Deserialize
-            auto file = make_unique<FileStream>(file_path, FileStream_Read);
+            // Deserialize, the geometry is copied straight from the data we were given or the mapped file
+            auto file = data ? make_unique<FileStream>(move(*data)) : make_unique<FileStream>(file_path, FileStream_Read | FileStream_Mmap);
             if (!file->IsOpen())
                 return false;
 
@@ -173,6 +184,7 @@ namespace Spartan
         GeometryCreateBuffers();
         m_normalized_scale    = GeometryComputeNormalizedScale();
         m_aabb                = BoundingBox(m_mesh->Vertices_Get().data(), static_cast<uint32_t>(m_mesh->Vertices_Get().size()));
+        m_is_modified         = true;
     }
 
     void Model::AddMaterial(shared_ptr<Material>& material, const shared_ptr<Entity>& entity) const
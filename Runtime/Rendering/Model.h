@@ -47,6 +47,7 @@ namespace Spartan
 
         //= IResource ===========================================
         bool LoadFromFile(const std::string& file_path) override;
+        bool LoadFromMemory(const std::string& file_path, std::vector<std::byte>&& data) override;
         bool SaveToFile(const std::string& file_path) override;
         //=======================================================
 
@@ -82,6 +83,8 @@ namespace Spartan
         auto GetSharedPtr()                                  { return shared_from_this(); }
 
     private:
+        bool Load(const std::string& file_path, std::vector<std::byte>* data);
+
         // Geometry
         bool GeometryCreateBuffers();
         float GeometryComputeNormalizedScale() const;
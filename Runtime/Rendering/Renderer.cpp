@@ -29,8 +29,10 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Gizmos/Grid.h"
 #include "Gizmos/Transform_Gizmo.h"
 #include "../Utilities/Sampling.h"
+#include "../Utilities/Sort.h"
 #include "../Profiling/Profiler.h"
 #include "../Resource/ResourceCache.h"
+#include "../Threading/Threading.h"
 #include "../World/Entity.h"
 #include "../World/Components/Transform.h"
 #include "../World/Components/Renderable.h"
@@ -46,6 +48,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../RHI/RHI_DescriptorSetLayoutCache.h"
 #include "../RHI/RHI_Implementation.h"
 #include "../RHI/RHI_Semaphore.h"
+#include <bit>
 //==============================================
 
 //= NAMESPACES ===============
@@ -86,16 +89,17 @@ namespace Spartan
         m_option_values[Renderer_Option_Value::Fog]                 = 0.1f;
 
         // Subscribe to events
-        SUBSCRIBE_TO_EVENT(EventType::WorldResolved,    EVENT_HANDLER_VARIANT(RenderablesAcquire));
+        SUBSCRIBE_TO_EVENT(EventType::WorldResolved,    EVENT_HANDLER_VARIANT(RenderablesUpdate));
         SUBSCRIBE_TO_EVENT(EventType::WorldClear,       EVENT_HANDLER(Clear));
     }
 
     Renderer::~Renderer()
     {
         // Unsubscribe from events
-        UNSUBSCRIBE_FROM_EVENT(EventType::WorldResolved, EVENT_HANDLER_VARIANT(RenderablesAcquire));
+        UNSUBSCRIBE_FROM_EVENT(EventType::WorldResolved, EVENT_HANDLER_VARIANT(RenderablesUpdate));
 
         m_entities.clear();
+        m_entities_registered.clear();
         m_camera = nullptr;
 
         // Log to file as the renderer is no more
@@ -107,6 +111,7 @@ namespace Spartan
         // Get required systems
         m_resource_cache    = m_context->GetSubsystem<ResourceCache>();
         m_profiler          = m_context->GetSubsystem<Profiler>();
+        m_threading         = m_context->GetSubsystem<Threading>();
 
         // Resolution, viewport and swapchain default to whatever the window size is
         const WindowData& window_data = m_context->m_engine->GetWindowData();
@@ -234,6 +239,7 @@ namespace Spartan
                 m_buffer_frame_offset_index     = 0;
                 m_buffer_light_offset_index     = 0;
                 m_buffer_material_offset_index  = 0;
+                m_buffer_instances_offset_index = 0;
             }
 
             // Update frame buffer
@@ -295,6 +301,30 @@ namespace Spartan
                 m_buffer_frame_cpu.frame                        = static_cast<uint32_t>(m_frame_num);
             }
 
+            // Move the entities whose material switched between opaque and transparent
+            if (m_renderables_reclassify.exchange(false))
+            {
+                for (const Renderer_Object_Type object_type : { Renderer_Object_Opaque, Renderer_Object_Transparent })
+                {
+                    // Copy, as registering can move an entity to the other list
+                    const vector<Entity*> entities = m_entities[object_type];
+                    for (Entity* entity : entities)
+                    {
+                        RenderablesRegister(entity);
+                    }
+                }
+
+                RenderablesRemoveUnregistered();
+            }
+
+            // Sorting and culling read the transforms from multiple threads, so any that were moved since the last
+            // frame (by physics, scripts or the editor) have to be resolved first (independent hierarchies don't race).
+            m_context->GetSubsystem<World>()->UpdateTransforms();
+
+            // Sort first, the culling preserves the order of the entities
+            RenderablesSort(&m_entities[Renderer_Object_Opaque], false);
+            RenderablesSort(&m_entities[Renderer_Object_Transparent], true);
+            RenderablesCull();
             Pass_Main(cmd_list);
 
             DrawDebugTick(delta_time);
@@ -362,18 +392,16 @@ namespace Spartan
         LOG_INFO("Resolution set to %dx%d", width, height);
     }
 
+    // Moves a buffer to its next offset, re-allocating it with double the size (if needed), and maps it.
+    // Returns where the data has to be written, the offset is zero for buffers which are not dynamic.
     template<typename T>
-    bool update_dynamic_buffer(RHI_CommandList* cmd_list, RHI_ConstantBuffer* buffer_gpu, T& buffer_cpu, T& buffer_cpu_previous, uint32_t& offset_index)
+    std::byte* map_dynamic_buffer(RHI_CommandList* cmd_list, RHI_ConstantBuffer* buffer_gpu, uint32_t& offset_index, uint64_t& offset)
     {
-        // Only update if needed
-        if (buffer_cpu == buffer_cpu_previous)
-            return true;
-
         offset_index++;
 
-        // Re-allocate buffer with double size (if needed)
         if (buffer_gpu->IsDynamic())
         {
+            // Re-allocate buffer with double size (if needed)
             if (offset_index >= buffer_gpu->GetOffsetCount())
             {
                 cmd_list->Flush();
@@ -381,42 +409,45 @@ namespace Spartan
                 if (!buffer_gpu->Create<T>(new_size))
                 {
                     LOG_ERROR("Failed to re-allocate %s buffer with %d offsets", buffer_gpu->GetName().c_str(), new_size);
-                    return false;
+                    return nullptr;
                 }
                 LOG_INFO("Increased %s buffer offsets to %d, that's %d kb", buffer_gpu->GetName().c_str(), new_size, (new_size * buffer_gpu->GetStride()) / 1000);
             }
-        }
 
-        // Set new buffer offset
-        if (buffer_gpu->IsDynamic())
-        {
+            // Set new buffer offset
             buffer_gpu->SetOffsetIndexDynamic(offset_index);
         }
 
-        // Map  
-        T* buffer = static_cast<T*>(buffer_gpu->Map());
+        // Map
+        std::byte* buffer = static_cast<std::byte*>(buffer_gpu->Map());
         if (!buffer)
         {
             LOG_ERROR("Failed to map buffer");
-            return false;
+            return nullptr;
         }
 
-        const uint64_t size   = buffer_gpu->GetStride();
-        const uint64_t offset = offset_index * size;
+        offset = buffer_gpu->IsDynamic() ? offset_index * buffer_gpu->GetStride() : 0;
+        return buffer + offset;
+    }
+
+    template<typename T>
+    bool update_dynamic_buffer(RHI_CommandList* cmd_list, RHI_ConstantBuffer* buffer_gpu, T& buffer_cpu, T& buffer_cpu_previous, uint32_t& offset_index)
+    {
+        // Only update if needed
+        if (buffer_cpu == buffer_cpu_previous)
+            return true;
+
+        uint64_t offset     = 0;
+        std::byte* buffer   = map_dynamic_buffer<T>(cmd_list, buffer_gpu, offset_index, offset);
+        if (!buffer)
+            return false;
 
         // Update
-        if (buffer_gpu->IsDynamic())
-        {
-            memcpy(reinterpret_cast<std::byte*>(buffer) + offset, reinterpret_cast<std::byte*>(&buffer_cpu), size);
-        }
-        else
-        {
-            *buffer = buffer_cpu;
-        }
+        memcpy(buffer, &buffer_cpu, sizeof(T));
         buffer_cpu_previous = buffer_cpu;
 
         // Unmap
-        return buffer_gpu->Unmap(offset, size);
+        return buffer_gpu->Unmap(offset, sizeof(T));
     }
 
     bool Renderer::UpdateFrameBuffer(RHI_CommandList* cmd_list)
@@ -491,6 +522,36 @@ namespace Spartan
         return cmd_list->SetConstantBuffer(2, RHI_Shader_Vertex | RHI_Shader_Pixel | RHI_Shader_Compute, m_buffer_uber_gpu);
     }
 
+    bool Renderer::UpdateInstanceBuffer(RHI_CommandList* cmd_list, const uint32_t instance_count, const bool copy_previous /*= false*/)
+    {
+        if (!cmd_list)
+        {
+            LOG_ERROR("Invalid command list");
+            return false;
+        }
+
+        // Every draw has different instances, so unlike the other buffers there is no point in comparing with the previous update
+        uint64_t offset     = 0;
+        std::byte* buffer   = map_dynamic_buffer<BufferInstances>(cmd_list, m_buffer_instances_gpu.get(), m_buffer_instances_offset_index, offset);
+        if (!buffer)
+            return false;
+
+        // Only copy the instances which are drawn, the previous transforms are only read by passes which output velocity
+        const uint64_t count = instance_count * sizeof(Matrix);
+        memcpy(buffer + offsetof(BufferInstances, transform), m_buffer_instances_cpu.transform.data(), count);
+        if (copy_previous)
+        {
+            memcpy(buffer + offsetof(BufferInstances, transform_previous), m_buffer_instances_cpu.transform_previous.data(), count);
+        }
+
+        // Unmap
+        if (!m_buffer_instances_gpu->Unmap(offset, sizeof(BufferInstances)))
+            return false;
+
+        // Dynamic buffers with offsets have to be rebound whenever the offset changes
+        return cmd_list->SetConstantBuffer(5, RHI_Shader_Vertex, m_buffer_instances_gpu);
+    }
+
     bool Renderer::UpdateLightBuffer(RHI_CommandList* cmd_list, const Light* light)
     {
         if (!cmd_list)
@@ -536,72 +597,198 @@ namespace Spartan
         return cmd_list->SetConstantBuffer(4, RHI_Shader_Pixel, m_buffer_light_gpu);
     }
 
-    void Renderer::RenderablesAcquire(const Variant& entities_variant)
+    void Renderer::RenderablesUpdate(const Variant& entities_variant)
     {
         SCOPED_TIME_BLOCK(m_profiler);
 
-        // Clear previous state
-        m_entities.clear();
-        m_camera = nullptr;
-
-        vector<shared_ptr<Entity>> entities = entities_variant.Get<vector<shared_ptr<Entity>>>();
-        for (const auto& entity : entities)
+        // Only the entities which changed since the last resolve are passed, so the lists are updated instead of rebuilt
+        const vector<shared_ptr<Entity>>* entities = entities_variant.Get<const vector<shared_ptr<Entity>>*>();
+        for (const shared_ptr<Entity>& entity : *entities)
         {
-            if (!entity || !entity->IsActive())
-                continue;
+            if (entity)
+            {
+                RenderablesRegister(entity.get());
+            }
+        }
 
-            // Get all the components we are interested in
-            Renderable* renderable  = entity->GetComponent<Renderable>();
-            Light* light            = entity->GetComponent<Light>();
-            Camera* camera          = entity->GetComponent<Camera>();
+        RenderablesRemoveUnregistered();
+    }
 
-            if (renderable)
+    void Renderer::RenderablesRegister(Entity* entity)
+    {
+        // Work out which lists the entity belongs to
+        uint32_t mask = 0;
+        if (entity->IsActive() && !entity->IsPendingDestruction())
+        {
+            if (Renderable* renderable = entity->GetRenderable())
             {
-                bool is_transparent = false;
+                const Material* material    = renderable->GetMaterial();
+                const bool is_transparent   = material && material->GetColorAlbedo().w < 1.0f;
 
-                if (const Material* material = renderable->GetMaterial())
-                {
-                    is_transparent = material->GetColorAlbedo().w < 1.0f;
-                }
+                mask |= 1u << (is_transparent ? Renderer_Object_Transparent : Renderer_Object_Opaque);
+            }
 
-                m_entities[is_transparent ? Renderer_Object_Transparent : Renderer_Object_Opaque].emplace_back(entity.get());
+            if (entity->HasComponent<Light>())
+            {
+                mask |= 1u << Renderer_Object_Light;
             }
 
-            if (light)
+            if (entity->HasComponent<Camera>())
             {
-                m_entities[Renderer_Object_Light].emplace_back(entity.get());
+                mask |= 1u << Renderer_Object_Camera;
             }
+        }
+
+        const auto it = m_entities_registered.find(entity);
+        const uint32_t mask_previous = it != m_entities_registered.end() ? it->second : 0;
+        if (mask == mask_previous)
+            return;
+
+        if (mask != 0)
+        {
+            m_entities_registered[entity] = mask;
+        }
+        else
+        {
+            m_entities_registered.erase(it);
+        }
+
+        // Additions are appended, removals are deferred so that each list is compacted once
+        for (uint32_t object_type = Renderer_Object_Opaque; object_type <= Renderer_Object_Camera; object_type++)
+        {
+            const uint32_t bit = 1u << object_type;
+
+            if ((mask & bit) && !(mask_previous & bit))
+            {
+                m_entities[static_cast<Renderer_Object_Type>(object_type)].emplace_back(entity);
 
-            if (camera)
+                // The last camera is the one we render with
+                if (object_type == Renderer_Object_Camera)
+                {
+                    m_camera = entity->GetComponent<Camera>()->GetPtrShared<Camera>();
+                }
+            }
+            else if (!(mask & bit) && (mask_previous & bit))
             {
-                m_entities[Renderer_Object_Camera].emplace_back(entity.get());
-                m_camera = camera->GetPtrShared<Camera>();
+                m_entities_unregistered |= bit;
             }
         }
+    }
+
+    void Renderer::RenderablesRemoveUnregistered()
+    {
+        if (m_entities_unregistered == 0)
+            return;
+
+        for (uint32_t object_type = Renderer_Object_Opaque; object_type <= Renderer_Object_Camera; object_type++)
+        {
+            const uint32_t bit = 1u << object_type;
+            if (!(m_entities_unregistered & bit))
+                continue;
+
+            // Entities are only compared by address, the ones which are being destroyed are not touched
+            vector<Entity*>& entities = m_entities[static_cast<Renderer_Object_Type>(object_type)];
+            entities.erase(remove_if(entities.begin(), entities.end(), [this, bit](const Entity* entity)
+            {
+                const auto it = m_entities_registered.find(entity);
+                return it == m_entities_registered.end() || !(it->second & bit);
+            }), entities.end());
+        }
 
-        RenderablesSort(&m_entities[Renderer_Object_Opaque]);
-        RenderablesSort(&m_entities[Renderer_Object_Transparent]);
+        // If a camera was removed, fall back to the last one left
+        if (m_entities_unregistered & (1u << Renderer_Object_Camera))
+        {
+            const vector<Entity*>& cameras = m_entities[Renderer_Object_Camera];
+            m_camera = !cameras.empty() ? cameras.back()->GetComponent<Camera>()->GetPtrShared<Camera>() : nullptr;
+        }
+
+        m_entities_unregistered = 0;
     }
 
-    void Renderer::RenderablesSort(vector<Entity*>* renderables)
+    void Renderer::RenderablesSort(vector<Entity*>* renderables, const bool back_to_front)
     {
         if (!m_camera || renderables->size() <= 2)
             return;
 
-        auto comparison_op = [this](Entity* entity)
+        SCOPED_TIME_BLOCK(m_profiler);
+
+        const Vector3 camera_position = m_camera->GetTransform()->GetPosition();
+
+        // Compute a key per entity, so that sorting only has to compare integers.
+        // Opaque keys group draws by shader variation, material and geometry, to minimize state changes, and are front to back within a group.
+        // Transparent keys are back to front first, as blending has to be done in order. Ids are truncated, a collision only costs a rebind.
+        // Depth is the bit pattern of the squared distance to the camera, which preserves the order of positive floats.
+        m_sort_keys.resize(renderables->size());
+        m_threading->AddTaskLoop([this, renderables, &camera_position, back_to_front](const uint32_t start, const uint32_t end)
+        {
+            for (uint32_t i = start; i < end; i++)
+            {
+                uint64_t flags          = 0;
+                uint64_t material_id    = 0;
+                uint64_t model_id       = 0;
+                uint32_t depth          = 0;
+
+                if (Renderable* renderable = (*renderables)[i]->GetRenderable())
+                {
+                    const Material* material    = renderable->GetMaterial();
+                    const Model* model          = renderable->GeometryModel();
+                    flags                       = material ? material->GetFlags() : 0;
+                    material_id                 = material ? material->GetId() & 0xFFFF : 0;
+                    model_id                    = model ? model->GetId() & 0xFFFF : 0;
+                    depth                       = bit_cast<uint32_t>((renderable->GetAabb().GetCenter() - camera_position).LengthSquared());
+                }
+
+                if (!back_to_front)
+                {
+                    // flags (14 bits) | material (16 bits) | model (14 bits) | depth (20 bits)
+                    m_sort_keys[i] = ((flags & 0x3FFF) << 50) | (material_id << 34) | ((model_id & 0x3FFF) << 20) | (depth >> 11);
+                }
+                else
+                {
+                    // inverted depth (32 bits) | material (16 bits) | model (16 bits)
+                    m_sort_keys[i] = (static_cast<uint64_t>(~depth) << 32) | (material_id << 16) | model_id;
+                }
+            }
+        }, static_cast<uint32_t>(renderables->size()));
+
+        Utility::Sort::Radix(m_sort_keys, *renderables, m_threading);
+    }
+
+    void Renderer::RenderablesCull()
+    {
+        SCOPED_TIME_BLOCK(m_profiler);
+
+        // Views, the camera first, followed by every slice of every light that casts shadows
+        for (Culling& culling : m_culling)
         {
-            auto renderable = entity->GetRenderable();
-            if (!renderable)
-                return 0.0f;
+            culling.ClearViews();
+            culling.AddView(m_camera->GetFrustum());
+        }
+
+        m_culling_view_light.clear();
+        for (Entity* entity : m_entities[Renderer_Object_Light])
+        {
+            const Light* light = entity->GetComponent<Light>();
+            if (!light || !light->GetShadowsEnabled() || !light->GetDepthTexture())
+                continue;
 
-            return (renderable->GetAabb().GetCenter() - m_camera->GetTransform()->GetPosition()).LengthSquared();
-        };
+            m_culling_view_light[light] = m_culling[0].GetViewCount();
 
-        // Sort by depth (front to back)
-        sort(renderables->begin(), renderables->end(), [&comparison_op](Entity* a, Entity* b)
+            for (uint32_t array_index = 0; array_index < light->GetDepthTexture()->GetArraySize(); array_index++)
+            {
+                for (Culling& culling : m_culling)
+                {
+                    culling.AddView(light->GetFrustum(array_index), light->GetFrustumIgnoresNearPlane());
+                }
+            }
+        }
+
+        // Test
+        for (uint32_t i = 0; i < static_cast<uint32_t>(m_culling.size()); i++)
         {
-            return comparison_op(a) < comparison_op(b);
-        });
+            m_culling[i].SetObjects(m_entities[static_cast<Renderer_Object_Type>(i)], m_threading);
+            m_culling[i].Cull(m_threading);
+        }
     }
 
     void Renderer::Clear()
@@ -609,6 +796,9 @@ namespace Spartan
         // Flush to remove references to entity resources that will be deallocated
         Flush();
         m_entities.clear();
+        m_entities_registered.clear();
+        m_entities_unregistered = 0;
+        m_camera = nullptr;
     }
 
     const shared_ptr<Spartan::RHI_Texture>& Renderer::GetEnvironmentTexture()
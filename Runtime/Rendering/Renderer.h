@@ -28,6 +28,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Renderer_ConstantBuffers.h"
 #include "Renderer_Enums.h"
 #include "Material.h"
+#include "Culling.h"
 #include "../Core/ISubsystem.h"
 #include "../Math/Rectangle.h"
 #include "../RHI/RHI_Definition.h"
@@ -47,6 +48,7 @@ namespace Spartan
     class Grid;
     class Transform_Gizmo;
     class Profiler;
+    class Threading;
 
     namespace Math
     {
@@ -132,6 +134,7 @@ namespace Spartan
         RHI_Texture* GetDefaultTextureWhite()       const { return m_default_tex_white.get(); }
         RHI_Texture* GetDefaultTextureBlack()       const { return m_default_tex_black.get(); }
         RHI_Texture* GetDefaultTextureTransparent() const { return m_default_tex_transparent.get(); }
+        RHI_Texture* GetDefaultTextureNormal()      const { return m_default_tex_normal.get(); }
 
         // Global shader resources
         void SetGlobalShaderObjectTransform(RHI_CommandList* cmd_list, const Math::Matrix& transform);
@@ -155,6 +158,9 @@ namespace Spartan
         uint32_t GetMaxResolution() const;
         void Clear();
 
+        // Called by a material when it switches between opaque and transparent, the entities are moved to the right list on the next tick
+        void RenderablesReclassify() { m_renderables_reclassify = true; }
+
         // Passes
         void Pass_CopyToBackbuffer(RHI_CommandList* cmd_list);
 
@@ -212,11 +218,15 @@ namespace Spartan
         bool UpdateFrameBuffer(RHI_CommandList* cmd_list);
         bool UpdateMaterialBuffer(RHI_CommandList* cmd_list);
         bool UpdateUberBuffer(RHI_CommandList* cmd_list);
+        bool UpdateInstanceBuffer(RHI_CommandList* cmd_list, uint32_t instance_count, bool copy_previous = false);
         bool UpdateLightBuffer(RHI_CommandList* cmd_list, const Light* light);
 
         // Misc
-        void RenderablesAcquire(const Variant& renderables);
-        void RenderablesSort(std::vector<Entity*>* renderables);
+        void RenderablesUpdate(const Variant& entities);
+        void RenderablesRegister(Entity* entity);
+        void RenderablesRemoveUnregistered();
+        void RenderablesSort(std::vector<Entity*>* renderables, bool back_to_front);
+        void RenderablesCull();
 
         // Render textures
         std::unordered_map<RendererRt, std::shared_ptr<RHI_Texture>> m_render_targets;
@@ -228,6 +238,7 @@ namespace Spartan
         std::shared_ptr<RHI_Texture> m_default_tex_white;
         std::shared_ptr<RHI_Texture> m_default_tex_black;
         std::shared_ptr<RHI_Texture> m_default_tex_transparent;
+        std::shared_ptr<RHI_Texture> m_default_tex_normal;
         std::shared_ptr<RHI_Texture> m_gizmo_tex_light_directional;
         std::shared_ptr<RHI_Texture> m_gizmo_tex_light_point;
         std::shared_ptr<RHI_Texture> m_gizmo_tex_light_spot;
@@ -329,15 +340,29 @@ namespace Spartan
         BufferLight m_buffer_light_cpu_previous;
         std::shared_ptr<RHI_ConstantBuffer> m_buffer_light_gpu;
         uint32_t m_buffer_light_offset_index = 0;
+
+        BufferInstances m_buffer_instances_cpu;
+        std::shared_ptr<RHI_ConstantBuffer> m_buffer_instances_gpu;
+        uint32_t m_buffer_instances_offset_index = 0;
         //========================================================
 
         // Entities and material references
         std::unordered_map<Renderer_Object_Type, std::vector<Entity*>> m_entities;
+        std::unordered_map<const Entity*, uint32_t> m_entities_registered;  // the lists an entity is in, a bit per Renderer_Object_Type
+        uint32_t m_entities_unregistered    = 0;                            // the lists which have entities pending removal, a bit per Renderer_Object_Type
+        std::atomic<bool> m_renderables_reclassify = false;
         std::array<Material*, m_max_material_instances> m_material_instances;
         std::shared_ptr<Camera> m_camera;
+        std::vector<uint64_t> m_sort_keys;
+
+        // Visibility of the opaque and transparent entities, from the camera (view 0) and from every shadow map slice
+        std::array<Culling, 2> m_culling;
+        std::unordered_map<const Light*, uint32_t> m_culling_view_light; // the view of a light's first slice
+        static const uint32_t m_culling_view_camera = 0;
 
         // Dependencies
         Profiler* m_profiler            = nullptr;
         ResourceCache* m_resource_cache = nullptr;
+        Threading* m_threading          = nullptr;
     };
 }
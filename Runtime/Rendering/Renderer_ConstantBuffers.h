@@ -173,6 +173,15 @@ namespace Spartan
 
         bool operator!=(const BufferUber& rhs) const { return !(*this == rhs); }
     };
+
+    // High frequency - Updates per draw, the transforms of every instance drawn by it
+    struct BufferInstances
+    {
+        static constexpr uint32_t max_instances = 64; // must match the shader
+
+        std::array<Math::Matrix, max_instances> transform;
+        std::array<Math::Matrix, max_instances> transform_previous;
+    };
     
     // Light buffer
     struct BufferLight
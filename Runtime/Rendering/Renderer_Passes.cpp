@@ -49,6 +49,17 @@ using namespace Spartan::Math;
 
 namespace Spartan
 {
+    // Whether two renderables can be drawn by the same instanced draw call
+    static bool can_instance(const Renderable* a, const Renderable* b, const bool compare_material)
+    {
+        if (a->GeometryModel()        != b->GeometryModel())        return false;
+        if (a->GeometryIndexOffset()  != b->GeometryIndexOffset())  return false;
+        if (a->GeometryIndexCount()   != b->GeometryIndexCount())   return false;
+        if (a->GeometryVertexOffset() != b->GeometryVertexOffset()) return false;
+
+        return !compare_material || a->GetMaterial() == b->GetMaterial();
+    }
+
     void Renderer::SetGlobalSamplersAndConstantBuffers(RHI_CommandList* cmd_list) const
     {
         // Constant buffers
@@ -198,6 +209,11 @@ namespace Spartan
             if (!tex_depth)
                 continue;
 
+            // Acquire the light's first culling view
+            const auto it_view = m_culling_view_light.find(light);
+            if (it_view == m_culling_view_light.end())
+                continue;
+
             // Set render state
             static RHI_PipelineState pso;
             pso.shader_vertex                    = shader_v;
@@ -241,7 +257,22 @@ namespace Spartan
                 bool render_pass_active     = false;
                 uint32_t m_set_material_id  = 0;
 
-                for (uint32_t entity_index = 0; entity_index < static_cast<uint32_t>(entities.size()); entity_index++)
+                // Consecutive entities which share geometry (and material, for transparents) are drawn as instances
+                const Renderable* batch_renderable  = nullptr;
+                uint32_t batch_count                = 0;
+                const auto batch_draw = [this, cmd_list, &batch_renderable, &batch_count]()
+                {
+                    if (batch_count != 0 && UpdateInstanceBuffer(cmd_list, batch_count))
+                    {
+                        cmd_list->DrawIndexedInstanced(batch_renderable->GeometryIndexCount(), batch_count, batch_renderable->GeometryIndexOffset(), batch_renderable->GeometryVertexOffset());
+                    }
+                    batch_count = 0;
+                };
+
+                // Only objects inside this slice's frustum
+                const vector<uint32_t>& entities_visible = m_culling[object_type].GetVisible(it_view->second + array_index);
+
+                for (const uint32_t entity_index : entities_visible)
                 {
                     Entity* entity = entities[entity_index];
 
@@ -264,15 +295,23 @@ namespace Spartan
                     if (!material)
                         continue;
 
-                    // Skip objects outside of the view frustum
-                    if (!light->IsInViewFrustrum(renderable, array_index))
-                        continue;
-
                     if (!render_pass_active)
                     {
                         render_pass_active = cmd_list->BeginRenderPass(pso);
+
+                        // The cascade transform is the same for every draw, instance transforms are applied on top of it
+                        m_buffer_uber_cpu.transform = view_projection;
+                        UpdateUberBuffer(cmd_list);
                     }
 
+                    // Append to the current batch, if possible
+                    if (batch_count != 0 && batch_count < BufferInstances::max_instances && can_instance(batch_renderable, renderable, transparent_pass))
+                    {
+                        m_buffer_instances_cpu.transform[batch_count++] = entity->GetTransform()->GetMatrix();
+                        continue;
+                    }
+                    batch_draw();
+
                     // Bind material
                     if (transparent_pass && m_set_material_id != material->GetId())
                     {
@@ -284,6 +323,7 @@ namespace Spartan
                         m_buffer_uber_cpu.mat_albedo    = material->GetColorAlbedo();
                         m_buffer_uber_cpu.mat_tiling_uv = material->GetTiling();
                         m_buffer_uber_cpu.mat_offset_uv = material->GetOffset();
+                        UpdateUberBuffer(cmd_list);
 
                         m_set_material_id = material->GetId();
                     }
@@ -292,16 +332,14 @@ namespace Spartan
                     cmd_list->SetBufferIndex(model->GetIndexBuffer());
                     cmd_list->SetBufferVertex(model->GetVertexBuffer());
 
-                    // Update uber buffer with cascade transform
-                    m_buffer_uber_cpu.transform = entity->GetTransform()->GetMatrix() * view_projection;
-                    if (!UpdateUberBuffer(cmd_list))
-                        continue;
-
-                    cmd_list->DrawIndexed(renderable->GeometryIndexCount(), renderable->GeometryIndexOffset(), renderable->GeometryVertexOffset());
+                    // Start a new batch
+                    batch_renderable = renderable;
+                    m_buffer_instances_cpu.transform[batch_count++] = entity->GetTransform()->GetMatrix();
                 }
 
                 if (render_pass_active)
                 {
+                    batch_draw();
                     cmd_list->EndRenderPass();
                 }
             }
@@ -343,9 +381,27 @@ namespace Spartan
                 // Variables that help reduce state changes
                 uint32_t currently_bound_geometry = 0;
 
-                // Draw opaque
-                for (const auto& entity : entities)
+                // The view projection is the same for every draw, instance transforms are applied on top of it
+                m_buffer_uber_cpu.transform = m_buffer_frame_cpu.view_projection;
+                UpdateUberBuffer(cmd_list);
+
+                // Consecutive entities which share geometry are drawn as instances
+                const Renderable* batch_renderable  = nullptr;
+                uint32_t batch_count                = 0;
+                const auto batch_draw = [this, cmd_list, &batch_renderable, &batch_count]()
                 {
+                    if (batch_count != 0 && UpdateInstanceBuffer(cmd_list, batch_count))
+                    {
+                        cmd_list->DrawIndexedInstanced(batch_renderable->GeometryIndexCount(), batch_count, batch_renderable->GeometryIndexOffset(), batch_renderable->GeometryVertexOffset());
+                    }
+                    batch_count = 0;
+                };
+
+                // Draw opaque (only objects inside the view frustum)
+                for (const uint32_t entity_index : m_culling[Renderer_Object_Opaque].GetVisible(m_culling_view_camera))
+                {
+                    Entity* entity = entities[entity_index];
+
                     // Get renderable
                     Renderable* renderable = entity->GetRenderable();
                     if (!renderable)
@@ -356,9 +412,13 @@ namespace Spartan
                     if (!model || !model->GetVertexBuffer() || !model->GetIndexBuffer())
                         continue;
 
-                    // Skip objects outside of the view frustum
-                    if (!m_camera->IsInViewFrustrum(renderable))
+                    // Append to the current batch, if possible
+                    if (batch_count != 0 && batch_count < BufferInstances::max_instances && can_instance(batch_renderable, renderable, false))
+                    {
+                        m_buffer_instances_cpu.transform[batch_count++] = entity->GetTransform()->GetMatrix();
                         continue;
+                    }
+                    batch_draw();
 
                     // Bind geometry
                     if (currently_bound_geometry != model->GetId())
@@ -368,17 +428,12 @@ namespace Spartan
                         currently_bound_geometry = model->GetId();
                     }
 
-                    // Update uber buffer with entity transform
-                    if (Transform* transform = entity->GetTransform())
-                    {
-                        // Update uber buffer with cascade transform
-                        m_buffer_uber_cpu.transform = transform->GetMatrix() * m_buffer_frame_cpu.view_projection;
-                        UpdateUberBuffer(cmd_list);
-                    }
-
-                    // Draw    
-                    cmd_list->DrawIndexed(renderable->GeometryIndexCount(), renderable->GeometryIndexOffset(), renderable->GeometryVertexOffset());
+                    // Start a new batch
+                    batch_renderable = renderable;
+                    m_buffer_instances_cpu.transform[batch_count++] = entity->GetTransform()->GetMatrix();
                 }
+
+                batch_draw();
             }
             cmd_list->EndRenderPass();
         }
@@ -439,10 +494,23 @@ namespace Spartan
             pso.pass_name = is_transparent_pass ? "GBuffer_Transparent" : "GBuffer_Opaque";
 
             bool render_pass_active = false;
-            auto& entities = m_entities[is_transparent_pass ? Renderer_Object_Transparent : Renderer_Object_Opaque];
+            const Renderer_Object_Type object_type = is_transparent_pass ? Renderer_Object_Transparent : Renderer_Object_Opaque;
+            auto& entities = m_entities[object_type];
 
-            // Record commands
-            for (uint32_t i = 0; i < static_cast<uint32_t>(entities.size()); i++)
+            // Consecutive entities which share geometry and material are drawn as instances
+            const Renderable* batch_renderable  = nullptr;
+            uint32_t batch_count                = 0;
+            const auto batch_draw = [this, cmd_list, &batch_renderable, &batch_count]()
+            {
+                if (batch_count != 0 && UpdateInstanceBuffer(cmd_list, batch_count, true))
+                {
+                    cmd_list->DrawIndexedInstanced(batch_renderable->GeometryIndexCount(), batch_count, batch_renderable->GeometryIndexOffset(), batch_renderable->GeometryVertexOffset());
+                }
+                batch_count = 0;
+            };
+
+            // Record commands (only objects inside the view frustum)
+            for (const uint32_t i : m_culling[object_type].GetVisible(m_culling_view_camera))
             {
                 Entity* entity = entities[i];
 
@@ -469,10 +537,6 @@ namespace Spartan
                 if (!model || !model->GetVertexBuffer() || !model->GetIndexBuffer())
                     continue;
 
-                // Skip objects outside of the view frustum
-                if (!m_camera->IsInViewFrustrum(renderable))
-                    continue;
-
                 if (!render_pass_active)
                 {
                     // Reset clear values after the first render pass
@@ -486,6 +550,19 @@ namespace Spartan
                     cleared = true;
                 }
 
+                // Append to the current batch, if possible
+                Transform* transform = entity->GetTransform();
+                if (batch_count != 0 && batch_count < BufferInstances::max_instances && can_instance(batch_renderable, renderable, true))
+                {
+                    m_buffer_instances_cpu.transform[batch_count]          = transform->GetMatrix();
+                    m_buffer_instances_cpu.transform_previous[batch_count] = transform->GetMatrixPrevious();
+                    transform->SetWvpLastFrame(m_buffer_instances_cpu.transform[batch_count]);
+                    batch_count++;
+                    m_profiler->m_renderer_meshes_rendered++;
+                    continue;
+                }
+                batch_draw();
+
                 // Set geometry (will only happen if not already set)
                 cmd_list->SetBufferIndex(model->GetIndexBuffer());
                 cmd_list->SetBufferVertex(model->GetVertexBuffer());
@@ -511,6 +588,9 @@ namespace Spartan
                         LOG_ERROR("Material instance array has reached it's maximum capacity of %d elements. Consider increasing the size.", m_max_material_instances);
                     }
 
+                    // The material is visible, so any of its textures which are still loading are needed now (placeholders are bound until then)
+                    material->PrioritizeTextures(TaskPriority::Normal);
+
                     // Bind material textures
                     cmd_list->SetTexture(RendererBindingsSrv::material_albedo,      material->GetTexture_Ptr(Material_Color));
                     cmd_list->SetTexture(RendererBindingsSrv::material_roughness,   material->GetTexture_Ptr(Material_Roughness));
@@ -534,28 +614,22 @@ namespace Spartan
                     // Update constant buffer
                     UpdateUberBuffer(cmd_list);
                 }
-                
-                // Update uber buffer with entity transform
-                if (Transform* transform = entity->GetTransform())
-                {
-                    m_buffer_uber_cpu.transform             = transform->GetMatrix();
-                    m_buffer_uber_cpu.transform_previous    = transform->GetMatrixPrevious();
 
-                    // Save matrix for velocity computation
-                    transform->SetWvpLastFrame(m_buffer_uber_cpu.transform);
+                // Start a new batch
+                batch_renderable = renderable;
+                m_buffer_instances_cpu.transform[batch_count]          = transform->GetMatrix();
+                m_buffer_instances_cpu.transform_previous[batch_count] = transform->GetMatrixPrevious();
 
-                    // Update object buffer
-                    if (!UpdateUberBuffer(cmd_list))
-                        continue;
-                }
-                
-                // Render
-                cmd_list->DrawIndexed(renderable->GeometryIndexCount(), renderable->GeometryIndexOffset(), renderable->GeometryVertexOffset());
+                // Save matrix for velocity computation
+                transform->SetWvpLastFrame(m_buffer_instances_cpu.transform[batch_count]);
+
+                batch_count++;
                 m_profiler->m_renderer_meshes_rendered++;
             }
 
             if (render_pass_active)
             {
+                batch_draw();
                 cmd_list->EndRenderPass();
             }
         }
@@ -58,6 +58,9 @@ namespace Spartan
 
         m_buffer_light_gpu = make_shared<RHI_ConstantBuffer>(m_rhi_device, "light", is_dynamic);
         m_buffer_light_gpu->Create<BufferLight>(m_swap_chain_buffer_count);
+
+        m_buffer_instances_gpu = make_shared<RHI_ConstantBuffer>(m_rhi_device, "instances", is_dynamic);
+        m_buffer_instances_gpu->Create<BufferInstances>(64);
     }
 
     void Renderer::CreateDepthStencilStates()
@@ -438,6 +441,9 @@ namespace Spartan
         m_default_tex_transparent = make_shared<RHI_Texture2D>(m_context, generate_mipmaps);
         m_default_tex_transparent->LoadFromFile(dir_texture + "transparent.png");
 
+        // A flat tangent space normal
+        m_default_tex_normal = make_shared<RHI_Texture2D>(m_context, 1, 1, RHI_Format_R8G8B8A8_Unorm, vector<std::byte>{ std::byte(128), std::byte(128), std::byte(255), std::byte(255) });
+
         // Gizmo icons
         m_gizmo_tex_light_directional = make_shared<RHI_Texture2D>(m_context, generate_mipmaps);
         m_gizmo_tex_light_directional->LoadFromFile(dir_texture + "sun.png");
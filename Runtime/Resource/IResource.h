@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ======================
 #include <memory>
+#include <vector>
 #include "../Core/Context.h"
 #include "../Core/FileSystem.h"
 #include "../Core/Spartan_Object.h"
@@ -46,6 +47,7 @@ namespace Spartan
         Font,
         Shader
     };
+    constexpr uint32_t resource_type_count = static_cast<uint32_t>(ResourceType::Shader) + 1;
 
     enum class LoadState
     {
@@ -106,10 +108,17 @@ namespace Spartan
         // Misc
         LoadState GetLoadState() const { return m_load_state; }
 
+        // Whether the resource has changed since it was last saved or loaded, unmodified resources are not saved with the world
+        bool IsModified() const                 { return m_is_modified; }
+        void SetModified(const bool modified)   { m_is_modified = modified; }
+
         // IO
         virtual bool SaveToFile(const std::string& file_path)    { return true; }
         virtual bool LoadFromFile(const std::string& file_path)    { return true; }
 
+        // Loads from the contents of the file, which were read beforehand (e.g. by a FileReadBatch). Resources which can't, read the file again.
+        virtual bool LoadFromMemory(const std::string& file_path, std::vector<std::byte>&& data) { return LoadFromFile(file_path); }
+
         // Type
         template <typename T>
         static constexpr ResourceType TypeToEnum();
@@ -117,6 +126,7 @@ namespace Spartan
     protected:
         ResourceType m_resource_type    = ResourceType::Unknown;
         LoadState m_load_state          = LoadState::Idle;
+        bool m_is_modified              = true;
 
     private:
         std::string m_resource_name;
@@ -29,6 +29,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../World/World.h"
 #include "../World/Entity.h"
 #include "../IO/FileStream.h"
+#include "../IO/FileReadBatch.h"
+#include "../Threading/Threading.h"
 #include "../RHI/RHI_Texture2D.h"
 #include "../RHI/RHI_TextureCube.h"
 #include "../Audio/AudioClip.h"
@@ -65,6 +67,12 @@ namespace Spartan
 
     ResourceCache::~ResourceCache()
     {
+        // Wait for any resources which are still loading
+        if (m_threading)
+        {
+            m_threading->Wait(m_requests_counter);
+        }
+
         // Unsubscribe from events
         UNSUBSCRIBE_FROM_EVENT(EventType::WorldSave,    EVENT_HANDLER(SaveResourcesToFiles));
         UNSUBSCRIBE_FROM_EVENT(EventType::WorldLoad,    EVENT_HANDLER(LoadResourcesFromFiles));
@@ -77,6 +85,8 @@ namespace Spartan
         m_importer_model    = make_shared<ModelImporter>(m_context);
         m_importer_font     = make_shared<FontImporter>(m_context);
 
+        m_threading = m_context->GetSubsystem<Threading>();
+
         return true;
     }
 
@@ -88,29 +98,233 @@ namespace Spartan
             return false;
         }
 
-        for (shared_ptr<IResource>& resource : m_resources)
+        shared_lock<shared_mutex> lock(m_mutex);
+        return Find(resource_name, resource_type) != nullptr;
+    }
+
+    shared_ptr<IResource> ResourceCache::GetByName(const string& name, const ResourceType type)
+    {
+        shared_lock<shared_mutex> lock(m_mutex);
+        return Find(name, type);
+    }
+
+    shared_ptr<IResource> ResourceCache::GetByPath(const string& path)
+    {
+        shared_lock<shared_mutex> lock(m_mutex);
+
+        auto it = m_resources_by_path.find(NormalizePath(path));
+        return it != m_resources_by_path.end() ? it->second : nullptr;
+    }
+
+    shared_ptr<IResource> ResourceCache::Find(const string& name, const ResourceType type) const
+    {
+        auto find_by_type = [this, &name](const ResourceType resource_type) -> shared_ptr<IResource>
         {
-            if (resource_name == resource->GetResourceName())
-                return true;
+            const auto& resources = m_resources_by_name[static_cast<uint32_t>(resource_type)];
+            auto it = resources.find(name);
+            return it != resources.end() ? it->second : nullptr;
+        };
+
+        // Unknown matches any type
+        if (type == ResourceType::Unknown)
+        {
+            for (uint32_t i = 0; i < resource_type_count; i++)
+            {
+                if (shared_ptr<IResource> resource = find_by_type(static_cast<ResourceType>(i)))
+                    return resource;
+            }
+
+            return nullptr;
         }
 
-        return false;
+        if (shared_ptr<IResource> resource = find_by_type(type))
+            return resource;
+
+        // Texture is the base of the 2D and cube textures, so it matches them too
+        if (type == ResourceType::Texture)
+        {
+            if (shared_ptr<IResource> resource = find_by_type(ResourceType::Texture2d))
+                return resource;
+
+            return find_by_type(ResourceType::TextureCube);
+        }
+
+        return nullptr;
     }
 
-    shared_ptr<IResource>& ResourceCache::GetByName(const string& name, const ResourceType type)
+    shared_ptr<IResource> ResourceCache::Cache(const shared_ptr<IResource>& resource, const bool save_to_file)
     {
-        for (shared_ptr<IResource>& resource : m_resources)
+        // Validate resource
+        if (!resource)
+            return nullptr;
+
+        // Validate resource file path
+        if (!resource->HasFilePathNative() && !FileSystem::IsDirectory(resource->GetResourceFilePathNative()))
         {
-            if (name == resource->GetResourceName())
-                return resource;
+            LOG_ERROR("A resource must have a valid file path in order to be cached");
+            return nullptr;
+        }
+
+        // Validate resource file path
+        if (!FileSystem::IsEngineFile(resource->GetResourceFilePathNative()))
+        {
+            LOG_ERROR("A resource must have a native file format in order to be cached, provide format was %s", FileSystem::GetExtensionFromFilePath(resource->GetResourceFilePathNative()).c_str());
+            return nullptr;
+        }
+
+        // Add it, or get the already cached resource if another thread got there first
+        shared_ptr<IResource> cached = Add(resource);
+        if (cached != resource)
+            return cached;
+
+        // In order to guarantee deserialization, we save it now
+        if (save_to_file)
+        {
+            resource->SaveToFile(resource->GetResourceFilePathNative());
+        }
+
+        // Either way, the native file is up to date
+        resource->SetModified(false);
+
+        return resource;
+    }
+
+    shared_ptr<IResource> ResourceCache::Add(const shared_ptr<IResource>& resource)
+    {
+        unique_lock<shared_mutex> lock(m_mutex);
+
+        // Ensure that this resource is not already cached
+        if (shared_ptr<IResource> cached = Find(resource->GetResourceName(), resource->GetResourceType()))
+            return cached;
+
+        m_resources.emplace_back(resource);
+        m_resources_by_name[static_cast<uint32_t>(resource->GetResourceType())][resource->GetResourceName()] = resource;
+        m_resources_by_path[NormalizePath(resource->GetResourceFilePathNative())] = resource;
+
+        return resource;
+    }
+
+    void ResourceCache::Remove(const shared_ptr<IResource>& resource)
+    {
+        if (!resource)
+            return;
+
+        unique_lock<shared_mutex> lock(m_mutex);
+
+        auto it = find(m_resources.begin(), m_resources.end(), resource);
+        if (it == m_resources.end())
+            return;
+
+        m_resources.erase(it);
+
+        auto& resources_by_name = m_resources_by_name[static_cast<uint32_t>(resource->GetResourceType())];
+        auto it_name = resources_by_name.find(resource->GetResourceName());
+        if (it_name != resources_by_name.end() && it_name->second == resource)
+        {
+            resources_by_name.erase(it_name);
+        }
+
+        auto it_path = m_resources_by_path.find(NormalizePath(resource->GetResourceFilePathNative()));
+        if (it_path != m_resources_by_path.end() && it_path->second == resource)
+        {
+            m_resources_by_path.erase(it_path);
+        }
+    }
+
+    shared_ptr<ResourceRequest> ResourceCache::LoadAsync(const string& file_path, const ResourceType type, const TaskPriority priority, function<shared_ptr<IResource>()>&& load)
+    {
+        shared_ptr<ResourceRequest> request = make_shared<ResourceRequest>();
+
+        // Already loaded
+        if (shared_ptr<IResource> resource = GetByName(FileSystem::GetFileNameNoExtensionFromFilePath(file_path), type))
+        {
+            request->resource   = resource;
+            request->state      = LoadState::Completed;
+            return request;
+        }
+
+        request->file_path  = NormalizePath(file_path);
+        request->load       = move(load);
+        request->priority   = priority;
+
+        // Already loading, share the request
+        shared_ptr<ResourceRequest> request_pending;
+        {
+            lock_guard<mutex> lock(m_requests_mutex);
+
+            auto it = m_requests.find(request->file_path);
+            if (it != m_requests.end())
+            {
+                request_pending = it->second;
+            }
+            else
+            {
+                m_requests[request->file_path] = request;
+            }
         }
 
-        static shared_ptr<IResource> empty;
-        return empty;
+        if (request_pending)
+        {
+            Prioritize(request_pending, priority);
+            return request_pending;
+        }
+
+        Submit(request, priority);
+
+        return request;
+    }
+
+    void ResourceCache::Prioritize(const shared_ptr<ResourceRequest>& request, const TaskPriority priority)
+    {
+        // Queued tasks can't be moved to another lane, so the request is submitted again with the higher priority.
+        // Whichever task runs first does the loading, the other one returns.
+        TaskPriority priority_current = request->priority.load();
+        while (priority < priority_current && request->state.load() == LoadState::Idle)
+        {
+            if (request->priority.compare_exchange_weak(priority_current, priority))
+            {
+                Submit(request, priority);
+                return;
+            }
+        }
+    }
+
+    void ResourceCache::Submit(const shared_ptr<ResourceRequest>& request, const TaskPriority priority)
+    {
+        m_threading->AddTask([this, request]()
+        {
+            LoadState state_expected = LoadState::Idle;
+            if (!request->state.compare_exchange_strong(state_expected, LoadState::Started))
+                return;
+
+            shared_ptr<IResource> resource = request->load();
+            request->load = nullptr;
+
+            // Once loaded the resource is found by name, so the request is no longer needed
+            {
+                lock_guard<mutex> lock(m_requests_mutex);
+                m_requests.erase(request->file_path);
+            }
+
+            request->resource   = resource;
+            request->state      = resource ? LoadState::Completed : LoadState::Failed;
+        }, &m_requests_counter, priority);
+    }
+
+    string ResourceCache::NormalizePath(const string& path)
+    {
+        string path_normalized = FileSystem::GetRelativePath(path);
+        replace(path_normalized.begin(), path_normalized.end(), '\\', '/');
+        return path_normalized;
     }
 
     vector<shared_ptr<IResource>> ResourceCache::GetByType(const ResourceType type /*= ResourceType::Unknown*/)
     {
+        shared_lock<shared_mutex> lock(m_mutex);
+
+        if (type == ResourceType::Unknown)
+            return m_resources;
+
         vector<shared_ptr<IResource>> resources;
 
         for (shared_ptr<IResource>& resource : m_resources)
@@ -126,6 +340,8 @@ namespace Spartan
 
     uint64_t ResourceCache::GetMemoryUsageCpu(ResourceType type /*= Resource_Unknown*/)
     {
+        shared_lock<shared_mutex> lock(m_mutex);
+
         uint64_t size = 0;
 
         for (shared_ptr<IResource>& resource : m_resources)
@@ -144,6 +360,8 @@ namespace Spartan
 
     uint64_t ResourceCache::GetMemoryUsageGpu(ResourceType type /*= Resource_Unknown*/)
     {
+        shared_lock<shared_mutex> lock(m_mutex);
+
         uint64_t size = 0;
 
         for (shared_ptr<IResource>& resource : m_resources)
@@ -176,14 +394,16 @@ namespace Spartan
             return;
         }
 
-        const auto resource_count = GetResourceCount();
+        // Work on a snapshot so that saving doesn't hold the cache lock
+        const vector<shared_ptr<IResource>> resources = GetByType();
+        const uint32_t resource_count = static_cast<uint32_t>(resources.size());
         ProgressTracker::Get().SetJobCount(ProgressType::ResourceCache, resource_count);
 
         // Save resource count
         file->Write(resource_count);
 
         // Save all the currently used resources to disk
-        for (shared_ptr<IResource>& resource : m_resources)
+        for (const shared_ptr<IResource>& resource : resources)
         {
             if (!resource->HasFilePathNative())
                 continue;
@@ -192,8 +412,12 @@ namespace Spartan
             file->Write(resource->GetResourceFilePathNative());
             // Save type
             file->Write(static_cast<uint32_t>(resource->GetResourceType()));
-            // Save resource (to a dedicated file)
-            resource->SaveToFile(resource->GetResourceFilePathNative());
+            // Save resource (to a dedicated file), unless the file is already up to date
+            if (resource->IsModified())
+            {
+                resource->SaveToFile(resource->GetResourceFilePathNative());
+                resource->SetModified(false);
+            }
 
             // Update progress
             ProgressTracker::Get().IncrementJobsDone(ProgressType::ResourceCache);
@@ -214,6 +438,12 @@ namespace Spartan
         // Load resource count
         const auto resource_count = file->ReadAs<uint32_t>();
 
+        // The entities which are deserialized next expect the resources to be cached, so all the
+        // resources are loaded in parallel and the calling thread helps out until they are done.
+        // Models and textures in the engine's format can deserialize from memory, so their files are read in a single batch
+        // on the background lane and each one is deserialized by the job system as soon as its read completes.
+        FileReadBatch batch(m_threading);
+        TaskCounter counter;
         for (uint32_t i = 0; i < resource_count; i++)
         {
             // Load resource file path
@@ -222,43 +452,74 @@ namespace Spartan
             // Load resource type
             const auto type = static_cast<ResourceType>(file->ReadAs<uint32_t>());
 
-            switch (type)
+            if (FileSystem::IsEngineModelFile(file_path) || FileSystem::IsEngineTextureFile(file_path))
+            {
+                batch.Add(file_path, [this, type](const string& file_path, vector<std::byte>&& data)
+                {
+                    // If the read failed, let the resource try and report it
+                    LoadByType(file_path, type, data.empty() ? nullptr : &data);
+                });
+            }
+            else
             {
-            case ResourceType::Model:
-                Load<Model>(file_path);
-                break;
-            case ResourceType::Material:
-                Load<Material>(file_path);
-                break;
-            case ResourceType::Texture:
-                Load<RHI_Texture>(file_path);
-                break;
-            case ResourceType::Texture2d:
-                Load<RHI_Texture2D>(file_path);
-                break;
-            case ResourceType::TextureCube:
-                Load<RHI_TextureCube>(file_path);
-                break;
-            case ResourceType::Audio:
-                Load<AudioClip>(file_path);
-                break;
+                m_threading->AddTask([this, file_path, type]() { LoadByType(file_path, type, nullptr); }, &counter);
             }
         }
 
+        batch.Submit();
+        m_threading->Wait(counter);
+        batch.Wait();
+    }
+
+    void ResourceCache::LoadByType(const string& file_path, const ResourceType type, vector<std::byte>* data)
+    {
+        switch (type)
+        {
+        case ResourceType::Model:
+            Load<Model>(file_path, data);
+            break;
+        case ResourceType::Material:
+            Load<Material>(file_path, data);
+            break;
+        case ResourceType::Texture:
+            Load<RHI_Texture>(file_path, data);
+            break;
+        case ResourceType::Texture2d:
+            Load<RHI_Texture2D>(file_path, data);
+            break;
+        case ResourceType::TextureCube:
+            Load<RHI_TextureCube>(file_path, data);
+            break;
+        case ResourceType::Audio:
+            Load<AudioClip>(file_path, data);
+            break;
+        }
     }
 
     void ResourceCache::Clear()
     {
+        unique_lock<shared_mutex> lock(m_mutex);
+
         uint32_t resource_count = static_cast<uint32_t>(m_resources.size());
 
         m_resources.clear();
+        m_resources_by_path.clear();
+        for (auto& resources : m_resources_by_name)
+        {
+            resources.clear();
+        }
 
         LOG_INFO("%d resources have been cleared", resource_count);
     }
 
     uint32_t ResourceCache::GetResourceCount(const ResourceType type)
     {
-        return static_cast<uint32_t>(GetByType(type).size());
+        shared_lock<shared_mutex> lock(m_mutex);
+
+        if (type == ResourceType::Unknown)
+            return static_cast<uint32_t>(m_resources.size());
+
+        return static_cast<uint32_t>(m_resources_by_name[static_cast<uint32_t>(type)].size());
     }
 
     void ResourceCache::AddResourceDirectory(const ResourceDirectory type, const string& directory)
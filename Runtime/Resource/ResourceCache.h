@@ -22,9 +22,13 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #pragma once
 
 //= INCLUDES ==================
+#include <array>
+#include <functional>
 #include <unordered_map>
+#include <shared_mutex>
 #include "IResource.h"
 #include "../Core/ISubsystem.h"
+#include "../Threading/Task.h"
 //=============================
 
 namespace Spartan
@@ -33,6 +37,8 @@ namespace Spartan
     class FontImporter;
     class ImageImporter;
     class ModelImporter;
+    class ResourceCache;
+    class Threading;
 
     enum class ResourceDirectory
     {
@@ -45,6 +51,43 @@ namespace Spartan
         Textures
     };
 
+    // The state of a resource which is loading asynchronously, shared by all the handles to it
+    struct ResourceRequest
+    {
+        std::string file_path;
+        std::function<std::shared_ptr<IResource>()> load;
+        std::shared_ptr<IResource> resource;                            // valid once the state is LoadState::Completed
+        std::atomic<LoadState> state        = LoadState::Idle;
+        std::atomic<TaskPriority> priority  = TaskPriority::Background;
+    };
+
+    // Returned by ResourceCache::LoadAsync(), usable right away
+    template <class T>
+    class ResourceHandle
+    {
+    public:
+        ResourceHandle() = default;
+        ResourceHandle(ResourceCache* resource_cache, std::shared_ptr<ResourceRequest> request, T* placeholder)
+            : m_resource_cache(resource_cache), m_request(std::move(request)), m_placeholder(placeholder) {}
+
+        // Returns the resource once it has loaded, the placeholder until then
+        T* Get() const { return IsLoaded() ? static_cast<T*>(m_request->resource.get()) : m_placeholder; }
+
+        // Returns the resource once it has loaded, null until then
+        std::shared_ptr<T> GetResource() const { return IsLoaded() ? std::static_pointer_cast<T>(m_request->resource) : nullptr; }
+
+        bool IsLoaded()             const { return GetLoadState() == LoadState::Completed; }
+        LoadState GetLoadState()    const { return m_request ? m_request->state.load() : LoadState::Idle; }
+
+        // Raises the priority of a load which hasn't started yet, for example when the resource becomes visible
+        void Prioritize(TaskPriority priority);
+
+    private:
+        ResourceCache* m_resource_cache = nullptr;
+        std::shared_ptr<ResourceRequest> m_request;
+        T* m_placeholder                = nullptr;
+    };
+
     class SPARTAN_CLASS ResourceCache : public ISubsystem
     {
     public:
@@ -56,7 +99,7 @@ namespace Spartan
         //=========================
 
         // Get by name
-        std::shared_ptr<IResource>& GetByName(const std::string& name, ResourceType type);
+        std::shared_ptr<IResource> GetByName(const std::string& name, ResourceType type);
         template <class T> 
         constexpr std::shared_ptr<T> GetByName(const std::string& name) 
         { 
@@ -67,76 +110,31 @@ namespace Spartan
         std::vector<std::shared_ptr<IResource>> GetByType(ResourceType type = ResourceType::Unknown);
 
         // Get by path
+        std::shared_ptr<IResource> GetByPath(const std::string& path);
         template <class T>
         std::shared_ptr<T> GetByPath(const std::string& path)
         {
-            for (std::shared_ptr<IResource>& resource : m_resources)
-            {
-                if (path == resource->GetResourceFilePathNative())
-                    return std::static_pointer_cast<T>(resource);
-            }
-
-            return nullptr;
+            return std::static_pointer_cast<T>(GetByPath(path));
         }
 
         // Caches resource, or replaces with existing cached resource
         template <class T>
         [[nodiscard]] std::shared_ptr<T> Cache(const std::shared_ptr<T>& resource)
         {
-            // Validate resource
-            if (!resource)
-                return nullptr;
-
-            // Validate resource file path
-            if (!resource->HasFilePathNative() && !FileSystem::IsDirectory(resource->GetResourceFilePathNative()))
-            {
-                LOG_ERROR("A resource must have a valid file path in order to be cached");
-                return nullptr;
-            }
-
-            // Validate resource file path
-            if (!FileSystem::IsEngineFile(resource->GetResourceFilePathNative()))
-            {
-                LOG_ERROR("A resource must have a native file format in order to be cached, provide format was %s", FileSystem::GetExtensionFromFilePath(resource->GetResourceFilePathNative()).c_str());
-                return nullptr;
-            }
-
-            // Ensure that this resource is not already cached
-            if (IsCached(resource->GetResourceName(), resource->GetResourceType()))
-                return GetByName<T>(resource->GetResourceName());
-
-            // Prevent threads from colliding in critical section
-            std::lock_guard<mutex> guard(m_mutex);
-
-            // In order to guarantee deserialization, we save it now
-            resource->SaveToFile(resource->GetResourceFilePathNative());
-
-            // Cache it
-            return static_pointer_cast<T>(m_resources.emplace_back(resource));
+            return std::static_pointer_cast<T>(Cache(std::static_pointer_cast<IResource>(resource), true));
         }
         bool IsCached(const std::string& resource_name, ResourceType resource_type);
 
         template <class T>
         void Remove(std::shared_ptr<T>& resource)
         {
-            if (!resource)
-                return;
-
-            if (!IsCached(resource->GetResourceName(), resource->GetResourceType()))
-                return;
-
-            m_resources.erase(
-                std::remove_if(
-                    m_resources.begin(),
-                    m_resources.end(),
-                    [](std::shared_ptr<IResource> resource) { return dynamic_cast<Spartan_Object*>(resource.get())->GetId() == resource->GetId(); }),
-                m_resources.end()
-            );
+            Remove(std::static_pointer_cast<IResource>(resource));
         }
+        void Remove(const std::shared_ptr<IResource>& resource);
 
-        // Loads a resource and adds it to the resource cache
+        // Loads a resource and adds it to the resource cache, the contents of the file can be passed if they have already been read
         template <class T>
-        std::shared_ptr<T> Load(const std::string& file_path)
+        std::shared_ptr<T> Load(const std::string& file_path, std::vector<std::byte>* data = nullptr)
         {
             if (!FileSystem::Exists(file_path))
             {
@@ -145,9 +143,8 @@ namespace Spartan
             }
 
             // Check if the resource is already loaded
-            const auto name = FileSystem::GetFileNameNoExtensionFromFilePath(file_path);
-            if (IsCached(name, IResource::TypeToEnum<T>()))
-                return GetByName<T>(name);
+            if (std::shared_ptr<T> cached = GetByName<T>(FileSystem::GetFileNameNoExtensionFromFilePath(file_path)))
+                return cached;
 
             // Create new resource
             auto typed = std::make_shared<T>(m_context);
@@ -156,16 +153,28 @@ namespace Spartan
             typed->SetResourceFilePath(file_path);
 
             // Load
-            if (!typed || !typed->LoadFromFile(file_path))
+            if (!typed || !(data ? typed->LoadFromMemory(file_path, std::move(*data)) : typed->LoadFromFile(file_path)))
             {
                 LOG_ERROR("Failed to load \"%s\".", file_path.c_str());
                 return nullptr;
             }
 
-            // Returned cached reference which is guaranteed to be around after deserialization
-            return Cache<T>(typed);
+            // Returned cached reference which is guaranteed to be around after deserialization.
+            // If the resource was read from its native format, it's already on disk, so there is no need to save it.
+            return std::static_pointer_cast<T>(Cache(typed, !FileSystem::IsEngineFile(file_path)));
         }
 
+        // Loads a resource on the thread pool, the returned handle gives the placeholder until the resource has loaded
+        template <class T>
+        ResourceHandle<T> LoadAsync(const std::string& file_path, const TaskPriority priority = TaskPriority::Background, T* placeholder = nullptr)
+        {
+            std::function<std::shared_ptr<IResource>()> load = [this, file_path]() { return std::static_pointer_cast<IResource>(Load<T>(file_path)); };
+            return ResourceHandle<T>(this, LoadAsync(file_path, IResource::TypeToEnum<T>(), priority, std::move(load)), placeholder);
+        }
+
+        // Raises the priority of a load which hasn't started yet
+        void Prioritize(const std::shared_ptr<ResourceRequest>& request, TaskPriority priority);
+
         //= MISC =============================================================
         // Memory
         uint64_t GetMemoryUsageCpu(ResourceType type = ResourceType::Unknown);
@@ -193,10 +202,25 @@ namespace Spartan
         // Event handlers
         void SaveResourcesToFiles();
         void LoadResourcesFromFiles();
+        void LoadByType(const std::string& file_path, ResourceType type, std::vector<std::byte>* data);
 
         // Cache
+        std::shared_ptr<IResource> Cache(const std::shared_ptr<IResource>& resource, bool save_to_file);
+        std::shared_ptr<IResource> Add(const std::shared_ptr<IResource>& resource);
+        std::shared_ptr<IResource> Find(const std::string& name, ResourceType type) const;
+        static std::string NormalizePath(const std::string& path);
         std::vector<std::shared_ptr<IResource>> m_resources;
-        std::mutex m_mutex;
+        std::array<std::unordered_map<std::string, std::shared_ptr<IResource>>, resource_type_count> m_resources_by_name; // indexed by ResourceType
+        std::unordered_map<std::string, std::shared_ptr<IResource>> m_resources_by_path;
+        mutable std::shared_mutex m_mutex;
+
+        // Asynchronous loading
+        std::shared_ptr<ResourceRequest> LoadAsync(const std::string& file_path, ResourceType type, TaskPriority priority, std::function<std::shared_ptr<IResource>()>&& load);
+        void Submit(const std::shared_ptr<ResourceRequest>& request, TaskPriority priority);
+        std::unordered_map<std::string, std::shared_ptr<ResourceRequest>> m_requests; // in flight, keyed by normalized path
+        std::mutex m_requests_mutex;
+        TaskCounter m_requests_counter;
+        Threading* m_threading = nullptr;
 
         // Directories
         std::unordered_map<ResourceDirectory, std::string> m_standard_resource_directories;
@@ -207,4 +231,13 @@ namespace Spartan
         std::shared_ptr<ImageImporter> m_importer_image;
         std::shared_ptr<FontImporter> m_importer_font;
     };
+
+    template <class T>
+    void ResourceHandle<T>::Prioritize(const TaskPriority priority)
+    {
+        if (m_request)
+        {
+            m_resource_cache->Prioritize(m_request, priority);
+        }
+    }
 }
@@ -0,0 +1,326 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =================
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Threading.h"
+#include "../IO/FileReadBatch.h"
+//============================
+
+// A coroutine which executes on the thread pool, allowing loading code to be written linearly without blocking the threads while it waits.
+//
+//  AsyncTask<std::shared_ptr<Model>> LoadModel(Threading* threading, const std::string& file_path)
+//  {
+//      std::vector<std::byte> data = co_await AwaitFileRead(threading, file_path); // suspends, the file is read on the background lane
+//      ...
+//      co_await AwaitNextFrame(threading);                                         // suspends, resumes on the main thread at the start of the next frame
+//      co_return model;
+//  }
+//
+// Coroutines are lazy, they start when they are awaited by another coroutine (on the awaiting thread) or when Start() is called (on the thread pool).
+// If an AsyncTask is destroyed while its coroutine is still running, the coroutine is detached and it will clean up after itself once it's done.
+
+namespace Spartan
+{
+    namespace async_task_internal
+    {
+        enum class State : uint8_t
+        {
+            Running,
+            Awaited,
+            Completed,
+            Detached
+        };
+
+        struct PromiseBase
+        {
+            struct FinalAwaiter
+            {
+                bool await_ready() const noexcept { return false; }
+
+                template <typename Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+                {
+                    PromiseBase& promise    = handle.promise();
+                    Threading* threading    = promise.threading;
+
+                    // Nobody owns this coroutine anymore
+                    const State state_previous = promise.state.exchange(State::Completed);
+                    if (state_previous == State::Detached)
+                    {
+                        handle.destroy();
+                        return std::noop_coroutine();
+                    }
+
+                    // The awaiter writes the continuation before it switches the state to Awaited, so it's only safe to read after the exchange
+                    const std::coroutine_handle<> continuation = state_previous == State::Awaited ? promise.continuation : std::noop_coroutine();
+
+                    // This is the last access to the promise, the owner can destroy the coroutine after this
+                    if (threading)
+                    {
+                        threading->Complete(promise.counter);
+                    }
+                    else
+                    {
+                        promise.counter.Decrement();
+                    }
+
+                    // Resume whoever awaited us
+                    return continuation;
+                }
+
+                void await_resume() const noexcept {}
+            };
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            FinalAwaiter final_suspend() const noexcept { return {}; }
+            void unhandled_exception() const noexcept { std::terminate(); } // the engine doesn't use exceptions
+
+            std::coroutine_handle<> continuation;
+            Threading* threading        = nullptr; // set if the coroutine was started on the thread pool
+            TaskCounter counter;                   // 1 while the coroutine is executing or suspended
+            std::atomic<State> state    = State::Running;
+            bool started                = false;   // only accessed by the owner
+        };
+
+        template <typename T>
+        struct PromiseResult : PromiseBase
+        {
+            template <typename U>
+            void return_value(U&& value) { result.emplace(std::forward<U>(value)); }
+
+            std::optional<T> result;
+        };
+
+        template <>
+        struct PromiseResult<void> : PromiseBase
+        {
+            void return_void() const {}
+        };
+    }
+
+    template <typename T = void>
+    class AsyncTask
+    {
+    public:
+        struct promise_type : async_task_internal::PromiseResult<T>
+        {
+            AsyncTask get_return_object() { return AsyncTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        };
+
+        AsyncTask() = default;
+        ~AsyncTask() { Release(); }
+
+        AsyncTask(const AsyncTask&)             = delete;
+        AsyncTask& operator=(const AsyncTask&)  = delete;
+
+        AsyncTask(AsyncTask&& other) noexcept : m_handle(other.m_handle) { other.m_handle = nullptr; }
+        AsyncTask& operator=(AsyncTask&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Release();
+                m_handle        = other.m_handle;
+                other.m_handle  = nullptr;
+            }
+
+            return *this;
+        }
+
+        // Starts executing the coroutine on the thread pool, the calling thread doesn't wait for it
+        void Start(Threading* threading, const TaskPriority priority = TaskPriority::Normal)
+        {
+            if (!m_handle || m_handle.promise().started)
+                return;
+
+            promise_type& promise   = m_handle.promise();
+            promise.threading       = threading;
+            promise.started         = true;
+            promise.counter.Increment();
+
+            threading->AddTask([handle = m_handle]() { handle.resume(); }, nullptr, priority);
+        }
+
+        // Blocks until the coroutine has completed, the calling thread helps with queued tasks in the meantime.
+        // Only valid for coroutines which were started with Start().
+        void Wait()
+        {
+            if (!m_handle || !m_handle.promise().threading)
+                return;
+
+            m_handle.promise().threading->Wait(m_handle.promise().counter);
+        }
+
+        // Returns true if there is no coroutine or if it has completed
+        bool IsDone() const
+        {
+            if (!m_handle)
+                return true;
+
+            return m_handle.promise().started && m_handle.promise().counter.IsDone();
+        }
+
+        // Only valid once the coroutine has completed
+        decltype(auto) GetResult()
+        {
+            if constexpr (!std::is_void_v<T>)
+            {
+                return *m_handle.promise().result;
+            }
+        }
+
+        // Awaiting a coroutine which hasn't started yet, starts it on the awaiting thread
+        auto operator co_await() const noexcept
+        {
+            struct Awaiter
+            {
+                bool await_ready() const noexcept
+                {
+                    return !handle || (handle.promise().started && handle.promise().counter.IsDone());
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+                {
+                    promise_type& promise   = handle.promise();
+                    promise.continuation    = awaiting;
+
+                    if (!promise.started)
+                    {
+                        promise.started = true;
+                        promise.state   = async_task_internal::State::Awaited;
+                        promise.counter.Increment();
+                        return handle;
+                    }
+
+                    // Already running on the thread pool, if it completed in the meantime, resume immediately
+                    async_task_internal::State expected = async_task_internal::State::Running;
+                    return promise.state.compare_exchange_strong(expected, async_task_internal::State::Awaited) ? std::noop_coroutine() : awaiting;
+                }
+
+                decltype(auto) await_resume() const
+                {
+                    if constexpr (!std::is_void_v<T>)
+                    {
+                        return std::move(*handle.promise().result);
+                    }
+                }
+
+                std::coroutine_handle<promise_type> handle;
+            };
+
+            return Awaiter{ m_handle };
+        }
+
+    private:
+        explicit AsyncTask(const std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+
+        void Release()
+        {
+            if (!m_handle)
+                return;
+
+            promise_type& promise = m_handle.promise();
+
+            if (!promise.started)
+            {
+                m_handle.destroy();
+            }
+            else
+            {
+                // If it's still running, detach it, it will destroy itself once it completes
+                async_task_internal::State expected = async_task_internal::State::Running;
+                if (!promise.state.compare_exchange_strong(expected, async_task_internal::State::Detached))
+                {
+                    // Completed, but it might still be releasing the counter
+                    while (!promise.counter.IsDone())
+                    {
+                        std::this_thread::yield();
+                    }
+
+                    m_handle.destroy();
+                }
+            }
+
+            m_handle = nullptr;
+        }
+
+        std::coroutine_handle<promise_type> m_handle;
+    };
+
+    // Resumes the awaiting coroutine on the main thread, at the start of the next frame
+    class AwaitNextFrame
+    {
+    public:
+        AwaitNextFrame(Threading* threading) : m_threading(threading) {}
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) const { m_threading->ResumeNextFrame(handle); }
+        void await_resume() const noexcept {}
+
+    private:
+        Threading* m_threading;
+    };
+
+    // Reads a file on the background lane and resumes the awaiting coroutine with its contents (empty if the read failed).
+    // The coroutine resumes on the background thread which did the read, unless a different priority is requested.
+    class AwaitFileRead
+    {
+    public:
+        AwaitFileRead(Threading* threading, std::string file_path, const TaskPriority priority = TaskPriority::Background)
+            : m_threading(threading), m_file_path(std::move(file_path)), m_priority(priority) {}
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            m_threading->AddTaskBackground([this, handle]()
+            {
+                m_data = FileReadBatch::ReadFile(m_file_path);
+
+                if (m_priority == TaskPriority::Background)
+                {
+                    handle.resume();
+                }
+                else
+                {
+                    m_threading->AddTask([handle]() { handle.resume(); }, nullptr, m_priority);
+                }
+            });
+        }
+
+        std::vector<std::byte> await_resume() { return std::move(m_data); }
+
+    private:
+        Threading* m_threading;
+        std::string m_file_path;
+        TaskPriority m_priority;
+        std::vector<std::byte> m_data;
+    };
+}
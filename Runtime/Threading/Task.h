@@ -0,0 +1,137 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==========
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+//=====================
+
+namespace Spartan
+{
+    enum class TaskPriority : uint8_t
+    {
+        Critical,   // Frame critical work, always picked up first
+        Normal,     // Default
+        Background  // Long running work (terrain generation, shader compilation, importing), executes on dedicated threads
+    };
+    constexpr uint32_t task_priority_count = 3;
+
+    // Tracks the completion of a group of tasks, see Threading::Wait()
+    class TaskCounter
+    {
+    public:
+        TaskCounter() = default;
+        TaskCounter(const TaskCounter&)             = delete;
+        TaskCounter& operator=(const TaskCounter&)  = delete;
+
+        void Increment(const uint32_t count = 1)    { m_value.fetch_add(count); }
+        bool Decrement()                            { return m_value.fetch_sub(1) == 1; } // returns true when the last task completes
+        bool IsDone() const                         { return m_value.load() == 0; }
+
+    private:
+        std::atomic<uint32_t> m_value = 0;
+    };
+
+    // A type erased, non-copyable callable. Callables which fit in the inline storage (which is the case for
+    // lambdas that capture a handful of pointers or a string) are constructed in place, so no heap allocation
+    // takes place. Larger callables fall back to the heap.
+    class Task
+    {
+    public:
+        static constexpr size_t storage_size = 64;
+
+        Task() = default;
+        ~Task() { Reset(); }
+
+        Task(const Task&)               = delete;
+        Task& operator=(const Task&)    = delete;
+
+        template <typename Function>
+        void Set(Function&& function)
+        {
+            using function_type = std::decay_t<Function>;
+
+            Reset();
+
+            if constexpr (sizeof(function_type) <= storage_size && alignof(function_type) <= alignof(std::max_align_t))
+            {
+                m_callable  = new (m_storage) function_type(std::forward<Function>(function));
+                m_destroy   = [](void* callable) { static_cast<function_type*>(callable)->~function_type(); };
+            }
+            else
+            {
+                m_callable  = new function_type(std::forward<Function>(function));
+                m_destroy   = [](void* callable) { delete static_cast<function_type*>(callable); };
+            }
+
+            m_invoke = [](void* callable) { (*static_cast<function_type*>(callable))(); };
+        }
+
+        void Execute() { m_invoke(m_callable); }
+
+        void Reset()
+        {
+            if (m_destroy)
+            {
+                m_destroy(m_callable);
+            }
+
+            m_callable  = nullptr;
+            m_invoke    = nullptr;
+            m_destroy   = nullptr;
+            m_counter   = nullptr;
+        }
+
+        // Scheduling
+        TaskPriority GetPriority() const                                        { return m_priority; }
+        void SetPriority(const TaskPriority priority)                           { m_priority = priority; }
+        std::chrono::steady_clock::time_point GetTimeSubmitted() const          { return m_time_submitted; }
+        void SetTimeSubmitted(const std::chrono::steady_clock::time_point time) { m_time_submitted = time; }
+
+        // The counter (if any) to decrement once the task has executed
+        TaskCounter* GetCounter() const             { return m_counter; }
+        void SetCounter(TaskCounter* counter)       { m_counter = counter; }
+
+        // Pool bookkeeping (see Threading::AllocateTask())
+        bool IsPooled() const               { return m_is_pooled; }
+        void SetPooled(const bool pooled)   { m_is_pooled = pooled; }
+        bool IsInUse() const                { return m_in_use.load(std::memory_order_acquire); }
+        void SetInUse(const bool in_use)    { m_in_use.store(in_use, std::memory_order_release); }
+
+    private:
+        alignas(std::max_align_t) std::byte m_storage[storage_size];
+        void* m_callable            = nullptr;
+        void (*m_invoke)(void*)     = nullptr;
+        void (*m_destroy)(void*)    = nullptr;
+        TaskCounter* m_counter      = nullptr;
+        TaskPriority m_priority     = TaskPriority::Normal;
+        std::chrono::steady_clock::time_point m_time_submitted;
+        std::atomic<bool> m_in_use  = false;
+        bool m_is_pooled            = false;
+    };
+}
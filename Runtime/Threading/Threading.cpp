@@ -30,28 +30,67 @@ using namespace std;
 
 namespace Spartan
 {
+    // Task storage which belongs to a single thread. Only the owning thread allocates from it,
+    // any thread can release a task back to it (by clearing the in-use flag) once it has executed.
+    struct TaskPool
+    {
+        static constexpr uint32_t capacity = 1024; // must be a power of two
+
+        TaskPool()
+        {
+            for (Task& task : tasks)
+            {
+                task.SetPooled(true);
+            }
+        }
+
+        array<Task, capacity> tasks;
+        uint32_t index = 0;
+    };
+
+    // Thread local state
+    static thread_local TaskPool* t_task_pool               = nullptr;
+    static thread_local const Threading* t_task_pool_owner  = nullptr;
+    static thread_local uint32_t t_queue_index              = numeric_limits<uint32_t>::max();
+    static thread_local bool t_is_background_thread         = false;
+
+    static uint32_t to_index(const TaskPriority priority) { return static_cast<uint32_t>(priority); }
+
     Threading::Threading(Context* context) : ISubsystem(context)
     {
-        m_stopping                               = false;
         m_thread_count_support                  = thread::hardware_concurrency();
         m_thread_count                          = m_thread_count_support - 1; // exclude the main (this) thread
         m_thread_names[this_thread::get_id()]   = "main";
 
+        // Create a critical and a normal queue for each worker, plus one for the main thread
+        for (auto& queues : m_queues)
+        {
+            for (uint32_t i = 0; i < m_thread_count + 1; i++)
+            {
+                queues.emplace_back(make_unique<TaskQueue>());
+            }
+        }
+        t_queue_index = m_thread_count;
+
         for (uint32_t i = 0; i < m_thread_count; i++)
         {
-            m_threads.emplace_back(thread(&Threading::ThreadLoop, this));
+            lock_guard<mutex> lock_names(m_mutex_thread_names);
+            m_threads.emplace_back(thread(&Threading::ThreadLoop, this, i));
             m_thread_names[m_threads.back().get_id()] = "worker_" + to_string(i);
         }
 
-        LOG_INFO("%d threads have been created", m_thread_count);
+        // Background threads, these are mostly waiting on I/O or executing long jobs, so they can oversubscribe the cores
+        SetBackgroundThreadCount(max(m_thread_count_support / 4, 2u));
+
+        LOG_INFO("%d worker threads and %d background threads have been created", m_thread_count, GetBackgroundThreadCount());
     }
 
     Threading::~Threading()
     {
-        Flush(true);
+        FlushAll(true);
 
-        // Put unique lock on task mutex.
-        unique_lock<mutex> lock(m_mutex_tasks);
+        // Put unique lock on the sleep mutex.
+        unique_lock<mutex> lock(m_mutex_sleep);
 
         // Set termination flag to true.
         m_stopping = true;
@@ -61,6 +100,7 @@ namespace Spartan
 
         // Wake up all threads.
         m_condition_var.notify_all();
+        m_condition_var_background.notify_all();
 
         // Join all threads.
         for (auto& thread : m_threads)
@@ -68,63 +108,472 @@ namespace Spartan
             thread.join();
         }
 
+        for (auto& thread : m_threads_background)
+        {
+            thread.join();
+        }
+
         // Empty worker threads.
         m_threads.clear();
+        m_threads_background.clear();
+
+        t_queue_index       = numeric_limits<uint32_t>::max();
+        t_task_pool         = nullptr;
+        t_task_pool_owner   = nullptr;
+    }
+
+    void Threading::Tick(float delta_time)
+    {
+        // Resume any coroutines which were waiting for this frame
+        vector<coroutine_handle<>> coroutines;
+        {
+            lock_guard<mutex> lock(m_mutex_coroutines_next_frame);
+            coroutines.swap(m_coroutines_next_frame);
+        }
+
+        for (coroutine_handle<> coroutine : coroutines)
+        {
+            coroutine.resume();
+        }
     }
 
     uint32_t Threading::GetThreadsAvailable() const
     {
-        uint32_t available_threads = m_thread_count;
+        const uint32_t threads_busy = m_tasks_executing.load();
+        return threads_busy < m_thread_count ? m_thread_count - threads_busy : 0;
+    }
+
+    template <typename Predicate>
+    void Threading::WaitUntil(Predicate&& is_done)
+    {
+        const bool background = t_is_background_thread;
 
-        for (const auto& task : m_tasks)
+        while (!is_done())
         {
-            available_threads -= task->IsExecuting() ? 1 : 0;
+            // Help with any queued tasks of our lane (this also drains the queue when waits are nested inside of tasks)
+            if (Task* task = background ? AcquireTaskBackground() : AcquireTask(t_queue_index))
+            {
+                ExecuteTask(task);
+                continue;
+            }
+
+            // Everything we could help with is already executing on other threads, so sleep until something completes
+            unique_lock<mutex> lock(m_mutex_wait);
+            m_threads_waiting++;
+            m_condition_var_wait.wait(lock, [this, &is_done, background]() { return is_done() || HasQueuedTasks(background); });
+            m_threads_waiting--;
         }
+    }
 
-        return available_threads;
+    void Threading::NotifyWaiters()
+    {
+        // Only touch the mutex if a thread is actually waiting
+        if (m_threads_waiting.load() == 0)
+            return;
+
+        {
+            lock_guard<mutex> lock(m_mutex_wait);
+        }
+
+        m_condition_var_wait.notify_all();
     }
 
     void Threading::Flush(bool remove_queued /*= false*/)
+    {
+        FlushLanes(remove_queued, false);
+    }
+
+    void Threading::FlushAll(bool remove_queued /*= false*/)
+    {
+        FlushLanes(remove_queued, true);
+    }
+
+    void Threading::FlushLanes(const bool remove_queued, const bool background)
     {
         // Clear any queued tasks
         if (remove_queued)
         {
-            m_tasks.clear();
+            auto discard = [this](Task* task)
+            {
+                const bool is_background = task->GetPriority() == TaskPriority::Background;
+                m_tasks_queued[to_index(task->GetPriority())]--;
+
+                if (TaskCounter* counter = task->GetCounter())
+                {
+                    counter->Decrement();
+                }
+
+                task->Reset();
+                ReleaseTask(task);
+                (is_background ? m_tasks_pending_background : m_tasks_pending)--;
+            };
+
+            for (auto& queues : m_queues)
+            {
+                for (auto& queue : queues)
+                {
+                    while (queue->GetSize() != 0)
+                    {
+                        if (Task* task = queue->Steal())
+                        {
+                            discard(task);
+                        }
+                    }
+                }
+            }
+
+            // Background tasks are only discarded when they are also waited for
+            const uint32_t priority_count = background ? task_priority_count : to_index(TaskPriority::Background);
+            for (uint32_t i = 0; i < priority_count; i++)
+            {
+                lock_guard<mutex> lock(m_mutex_tasks_shared[i]);
+                for (Task* task : m_tasks_shared[i])
+                {
+                    discard(task);
+                }
+                m_tasks_shared[i].clear();
+            }
+
+            NotifyWaiters();
         }
 
-        // If so, wait for them
-        while (AreTasksRunning())
+        // Wait for any queued or running tasks, helping out in the meantime
+        WaitUntil([this, background]() { return m_tasks_pending.load() == 0 && (!background || m_tasks_pending_background.load() == 0); });
+    }
+
+    void Threading::Wait(const TaskCounter& counter)
+    {
+        WaitUntil([&counter]() { return counter.IsDone(); });
+    }
+
+    void Threading::Complete(TaskCounter& counter)
+    {
+        if (counter.Decrement())
         {
-            std::this_thread::sleep_for(std::chrono::milliseconds(16));
+            NotifyWaiters();
         }
     }
 
-    void Threading::ThreadLoop()
+    void Threading::ResumeNextFrame(coroutine_handle<> handle)
+    {
+        lock_guard<mutex> lock(m_mutex_coroutines_next_frame);
+        m_coroutines_next_frame.emplace_back(handle);
+    }
+
+    void Threading::SetBackgroundThreadCount(uint32_t count)
+    {
+        // At least one, or background tasks would never execute
+        count = max(count, 1u);
+
+        lock_guard<mutex> lock(m_mutex_threads_background);
+
+        const uint32_t count_previous = static_cast<uint32_t>(m_threads_background.size());
+        if (count == count_previous)
+            return;
+
+        m_thread_count_background = count;
+
+        // Grow
+        for (uint32_t i = count_previous; i < count; i++)
+        {
+            lock_guard<mutex> lock_names(m_mutex_thread_names);
+            m_threads_background.emplace_back(thread(&Threading::ThreadLoopBackground, this, i));
+            m_thread_names[m_threads_background.back().get_id()] = "background_" + to_string(i);
+        }
+
+        // Shrink, threads with an index beyond the count exit as soon as they finish their current task
+        if (count < count_previous)
+        {
+            {
+                lock_guard<mutex> lock_sleep(m_mutex_sleep);
+            }
+            m_condition_var_background.notify_all();
+
+            for (uint32_t i = count; i < count_previous; i++)
+            {
+                {
+                    lock_guard<mutex> lock_names(m_mutex_thread_names);
+                    m_thread_names.erase(m_threads_background[i].get_id());
+                }
+                m_threads_background[i].join();
+            }
+
+            m_threads_background.resize(count);
+        }
+    }
+
+    string Threading::GetThreadName(const thread::id id) const
+    {
+        lock_guard<mutex> lock(m_mutex_thread_names);
+
+        const auto it = m_thread_names.find(id);
+        return it != m_thread_names.end() ? it->second : "unknown";
+    }
+
+    TaskStats Threading::GetStats(const TaskPriority priority) const
+    {
+        const uint32_t i = to_index(priority);
+
+        TaskStats stats;
+        stats.queue_depth       = m_tasks_queued[i].load();
+        stats.executed          = m_stats_executed[i].load();
+        stats.wait_time_avg_ms  = stats.executed != 0 ? static_cast<float>(static_cast<double>(m_stats_wait_us[i].load()) / stats.executed / 1000.0) : 0.0f;
+        stats.wait_time_max_ms  = static_cast<float>(static_cast<double>(m_stats_wait_max_us[i].load()) / 1000.0);
+
+        return stats;
+    }
+
+    void Threading::ResetStats()
     {
-        shared_ptr<Task> task;
+        for (uint32_t i = 0; i < task_priority_count; i++)
+        {
+            m_stats_executed[i]     = 0;
+            m_stats_wait_us[i]      = 0;
+            m_stats_wait_max_us[i]  = 0;
+        }
+    }
+
+    Task* Threading::AllocateTask()
+    {
+        // Acquire this thread's pool (created the first time a thread submits a task)
+        if (t_task_pool_owner != this)
+        {
+            lock_guard<mutex> lock(m_mutex_task_pools);
+            t_task_pool         = m_task_pools.emplace_back(make_unique<TaskPool>()).get();
+            t_task_pool_owner   = this;
+        }
+
+        // Pools are rings, by the time we wrap around the task has most likely executed
+        Task* task = &t_task_pool->tasks[t_task_pool->index++ & (TaskPool::capacity - 1)];
+        if (task->IsInUse())
+        {
+            // Too many tasks in flight, fall back to the heap
+            task = new Task();
+        }
+
+        task->SetInUse(true);
+        return task;
+    }
+
+    void Threading::ReleaseTask(Task* task)
+    {
+        if (task->IsPooled())
+        {
+            task->SetInUse(false);
+        }
+        else
+        {
+            delete task;
+        }
+    }
+
+    void Threading::Submit(Task* task)
+    {
+        const TaskPriority priority = task->GetPriority();
+        const uint32_t index        = to_index(priority);
+
+        task->SetTimeSubmitted(chrono::steady_clock::now());
+
+        (priority == TaskPriority::Background ? m_tasks_pending_background : m_tasks_pending)++;
+        m_tasks_queued[index]++;
+
+        if (priority == TaskPriority::Background)
+        {
+            {
+                lock_guard<mutex> lock(m_mutex_tasks_shared[index]);
+                m_tasks_shared[index].push_back(task);
+            }
+
+            // Wake up a background thread
+            if (m_threads_sleeping_background.load() != 0)
+            {
+                {
+                    lock_guard<mutex> lock(m_mutex_sleep);
+                }
+
+                m_condition_var_background.notify_one();
+            }
+        }
+        else
+        {
+            // Threads which own a queue push to it without any locking, others go through the shared queue
+            const bool has_queue = t_queue_index < static_cast<uint32_t>(m_queues[index].size());
+            if (!has_queue || !m_queues[index][t_queue_index]->Push(task))
+            {
+                lock_guard<mutex> lock(m_mutex_tasks_shared[index]);
+                m_tasks_shared[index].push_back(task);
+            }
+
+            // Wake up a worker, but only touch the mutex if one is actually sleeping
+            if (m_threads_sleeping.load() != 0)
+            {
+                {
+                    lock_guard<mutex> lock(m_mutex_sleep);
+                }
+
+                m_condition_var.notify_one();
+            }
+        }
+
+        // Threads blocked in Wait() can help with this task too
+        NotifyWaiters();
+    }
+
+    Task* Threading::AcquireTask(const uint32_t queue_index)
+    {
+        // Critical tasks first, then normal ones
+        for (uint32_t priority = 0; priority < static_cast<uint32_t>(m_queues.size()); priority++)
+        {
+            // Skip empty priorities
+            if (m_tasks_queued[priority].load() == 0)
+                continue;
+
+            auto& queues    = m_queues[priority];
+            Task* task      = nullptr;
+
+            // Own queue first (most recent work, likely still in cache)
+            if (queue_index < static_cast<uint32_t>(queues.size()))
+            {
+                task = queues[queue_index]->Pop();
+            }
+
+            // Then tasks submitted by external threads
+            if (!task)
+            {
+                unique_lock<mutex> lock(m_mutex_tasks_shared[priority], try_to_lock);
+                if (lock.owns_lock() && !m_tasks_shared[priority].empty())
+                {
+                    task = m_tasks_shared[priority].front();
+                    m_tasks_shared[priority].pop_front();
+                }
+            }
+
+            // Then steal from the other threads, starting from our neighbour
+            if (!task)
+            {
+                const uint32_t queue_count = static_cast<uint32_t>(queues.size());
+                for (uint32_t i = 1; i <= queue_count && !task; i++)
+                {
+                    const uint32_t victim = (queue_index + i) % queue_count;
+                    if (victim != queue_index)
+                    {
+                        task = queues[victim]->Steal();
+                    }
+                }
+            }
+
+            if (task)
+            {
+                m_tasks_queued[priority]--;
+                return task;
+            }
+        }
+
+        return nullptr;
+    }
+
+    Task* Threading::AcquireTaskBackground()
+    {
+        const uint32_t index = to_index(TaskPriority::Background);
+
+        lock_guard<mutex> lock(m_mutex_tasks_shared[index]);
+        if (m_tasks_shared[index].empty())
+            return nullptr;
+
+        Task* task = m_tasks_shared[index].front();
+        m_tasks_shared[index].pop_front();
+        m_tasks_queued[index]--;
+
+        return task;
+    }
+
+    bool Threading::HasQueuedTasks(const bool background) const
+    {
+        if (background)
+            return m_tasks_queued[to_index(TaskPriority::Background)].load() != 0;
+
+        return m_tasks_queued[to_index(TaskPriority::Critical)].load() != 0 || m_tasks_queued[to_index(TaskPriority::Normal)].load() != 0;
+    }
+
+    void Threading::ExecuteTask(Task* task)
+    {
+        TaskCounter* counter    = task->GetCounter();
+        const uint32_t index    = to_index(task->GetPriority());
+        const bool background   = task->GetPriority() == TaskPriority::Background;
+
+        // Statistics
+        {
+            const uint64_t wait_us = static_cast<uint64_t>(chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - task->GetTimeSubmitted()).count());
+            m_stats_executed[index]++;
+            m_stats_wait_us[index] += wait_us;
+
+            uint64_t wait_max_us = m_stats_wait_max_us[index].load();
+            while (wait_us > wait_max_us && !m_stats_wait_max_us[index].compare_exchange_weak(wait_max_us, wait_us)) {}
+        }
+
+        if (!background) m_tasks_executing++;
+        task->Execute();
+        task->Reset();
+        if (!background) m_tasks_executing--;
+
+        ReleaseTask(task);
+
+        // Notify any waiters if this was the last task of a counter or the last task overall
+        const bool counter_done = counter && counter->Decrement();
+        const bool all_done     = (background ? m_tasks_pending_background : m_tasks_pending).fetch_sub(1) == 1;
+        if (counter_done || all_done)
+        {
+            NotifyWaiters();
+        }
+    }
+
+    void Threading::ThreadLoop(const uint32_t queue_index)
+    {
+        t_queue_index = queue_index;
+
         while (true)
         {
-            // Lock tasks mutex
-            unique_lock<mutex> lock(m_mutex_tasks);
+            // Execute whatever we can find
+            if (Task* task = AcquireTask(queue_index))
+            {
+                ExecuteTask(task);
+                continue;
+            }
 
-            // Check condition on notification
-            m_condition_var.wait(lock, [this] { return !m_tasks.empty() || m_stopping; });
+            // Nothing to do, sleep until a task is submitted
+            unique_lock<mutex> lock(m_mutex_sleep);
+            m_threads_sleeping++;
+            m_condition_var.wait(lock, [this] { return HasQueuedTasks(false) || m_stopping; });
+            m_threads_sleeping--;
 
             // If m_stopping is true, it's time to shut everything down
-            if (m_stopping && m_tasks.empty())
+            if (m_stopping && !HasQueuedTasks(false))
                 return;
+        }
+    }
 
-            // Get next task in the queue.
-            task = m_tasks.front();
+    void Threading::ThreadLoopBackground(const uint32_t index)
+    {
+        t_is_background_thread = true;
 
-            // Remove it from the queue.
-            m_tasks.pop_front();
+        auto should_exit = [this, index]() { return m_stopping || index >= m_thread_count_background.load(); };
 
-            // Unlock the mutex
-            lock.unlock();
+        while (true)
+        {
+            if (Task* task = AcquireTaskBackground())
+            {
+                ExecuteTask(task);
+            }
+
+            // Exit if we are stopping or if the background thread count was reduced
+            if (should_exit() && !(m_stopping && HasQueuedTasks(true)))
+                return;
 
-            // Execute the task.
-            task->Execute();
+            // Nothing to do, sleep until a background task is submitted
+            unique_lock<mutex> lock(m_mutex_sleep);
+            m_threads_sleeping_background++;
+            m_condition_var_background.wait(lock, [this, &should_exit] { return HasQueuedTasks(true) || should_exit(); });
+            m_threads_sleeping_background--;
         }
     }
 }
@@ -23,29 +23,32 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ==================
 #include <vector>
+#include <array>
+#include <algorithm>
 #include <thread>
 #include <mutex>
 #include <deque>
+#include <atomic>
+#include <condition_variable>
 #include <unordered_map>
-#include <functional>
+#include <coroutine>
+#include "Task.h"
+#include "TaskQueue.h"
 #include "../Logging/Log.h"
 #include "../Core/ISubsystem.h"
 //=============================
 
 namespace Spartan
 {
-    class Task
-    {
-    public:
-        typedef std::function<void()> function_type;
-
-        Task(function_type&& function)  { m_function = std::forward<function_type>(function); }
-        void Execute()                  { m_is_executing = true; m_function(); m_is_executing = false; }
-        bool IsExecuting() const { return m_is_executing; }
+    struct TaskPool;
 
-    private:
-        bool m_is_executing = false;
-        function_type m_function;
+    // Per priority statistics, accumulated since the last call to Threading::ResetStats()
+    struct TaskStats
+    {
+        uint32_t queue_depth    = 0;    // tasks currently waiting to be picked up
+        uint64_t executed       = 0;    // tasks which have been picked up
+        float wait_time_avg_ms  = 0.0f; // time between submission and execution
+        float wait_time_max_ms  = 0.0f;
     };
 
     class Threading : public ISubsystem
@@ -54,9 +57,14 @@ namespace Spartan
         Threading(Context* context);
         ~Threading();
 
-        // Add a task
+        //= ISubsystem ======================
+        void Tick(float delta_time) override;
+        //===================================
+
+        // Add a task, if a counter is provided, it will be decremented once the task has executed (see Wait()).
+        // Critical and normal tasks execute on the worker threads, background tasks execute on the background threads.
         template <typename Function>
-        void AddTask(Function&& function)
+        void AddTask(Function&& function, TaskCounter* counter = nullptr, const TaskPriority priority = TaskPriority::Normal)
         {
             if (m_threads.empty())
             {
@@ -65,53 +73,68 @@ namespace Spartan
                 return;
             }
 
-            // Lock tasks mutex
-            std::unique_lock<std::mutex> lock(m_mutex_tasks);
+            // Construct the task in place (no allocation for small functions)
+            Task* task = AllocateTask();
+            task->Set(std::forward<Function>(function));
+            task->SetCounter(counter);
+            task->SetPriority(priority);
 
-            // Save the task
-            m_tasks.push_back(std::make_shared<Task>(std::bind(std::forward<Function>(function))));
+            if (counter)
+            {
+                counter->Increment();
+            }
 
-            // Unlock the mutex
-            lock.unlock();
+            // Queue it and wake up a thread
+            Submit(task);
+        }
 
-            // Wake up a thread
-            m_condition_var.notify_one();
+        // Add a background task
+        template <typename Function>
+        void AddTaskBackground(Function&& function, TaskCounter* counter = nullptr)
+        {
+            AddTask(std::forward<Function>(function), counter, TaskPriority::Background);
         }
 
-        // Adds a task which is a loop and executes chunks of it in parallel
+        // Splits [0, range) into chunks of grain_size and executes them in parallel, the calling thread participates.
+        // If grain_size is 0, the range is split into a few chunks per thread so that threads which finish early can steal the rest.
         template <typename Function>
-        void AddTaskLoop(Function&& function, uint32_t range)
+        void AddTaskLoop(Function&& function, const uint32_t range, uint32_t grain_size = 0, const TaskPriority priority = TaskPriority::Normal)
         {
-            uint32_t available_threads  = GetThreadsAvailable();
-            vector<bool> tasks_done     = vector<bool>(available_threads, false);
-            const uint32_t task_count   = available_threads + 1; // plus one for the current thread
+            if (range == 0)
+                return;
 
-            uint32_t start  = 0;
-            uint32_t end    = 0;
-            for (uint32_t i = 0; i < available_threads; i++)
+            if (grain_size == 0)
             {
-                start   = (range / task_count) * i;
-                end     = start + (range / task_count);
-
-                // Kick off task
-                AddTask([&function, &tasks_done, i, start, end] { function(start, end); tasks_done[i] = true; });
+                const uint32_t thread_count = priority == TaskPriority::Background ? GetBackgroundThreadCount() : m_thread_count;
+                grain_size = std::max(range / ((thread_count + 1) * 4), 1u);
             }
 
-            // Do last task in the current thread
-            function(end, range);
-
-            // Wait till the threads are done
-            uint32_t tasks = 0;
-            while (tasks != tasks_done.size())
+            // Queue all chunks but the first one
+            TaskCounter counter;
+            for (uint32_t start = grain_size; start < range; start += grain_size)
             {
-                tasks = 0;
-                for (const bool job_done : tasks_done)
-                {
-                    tasks += job_done ? 1 : 0;
-                }
+                const uint32_t end = std::min(start + grain_size, range);
+                AddTask([&function, start, end]() { function(start, end); }, &counter, priority);
             }
+
+            // Do the first chunk in the current thread
+            function(0, std::min(grain_size, range));
+
+            // Help with the remaining chunks until they are done
+            Wait(counter);
         }
 
+        // Blocks until all the tasks associated with the counter have executed.
+        // While waiting, the calling thread executes queued tasks of its own lane (worker or background),
+        // it only sleeps when there is nothing left to help with.
+        void Wait(const TaskCounter& counter);
+
+        // Decrements a counter which tracks work that wasn't submitted via AddTask() (e.g. a coroutine) and wakes up any waiters
+        void Complete(TaskCounter& counter);
+
+        // Resumes a suspended coroutine on the main thread, at the start of the next frame (see AwaitNextFrame)
+        void ResumeNextFrame(std::coroutine_handle<> handle);
+
         // Get the number of threads used
         uint32_t GetThreadCount()           const { return m_thread_count; }
         // Get the maximum number of threads the hardware supports
@@ -119,21 +142,87 @@ namespace Spartan
         // Get the number of threads which are not doing any work
         uint32_t GetThreadsAvailable()      const;
         // Returns true if at least one task is running
-        bool AreTasksRunning()              const { return GetThreadsAvailable() != GetThreadCount(); }
-        // Waits for all executing (and queued if requested) tasks to finish
+        bool AreTasksRunning()              const { return m_tasks_pending.load() != 0 || m_tasks_pending_background.load() != 0; }
+        // Waits for all executing (and queued if requested) critical and normal tasks to finish, background tasks keep running
         void Flush(bool remove_queued = false);
+        // Same as Flush() but it also waits for background tasks, which can take seconds (shader compilation, world loading, etc.)
+        void FlushAll(bool remove_queued = false);
+
+        // The name of a thread which is owned by this subsystem (or of the main thread), "unknown" for any other thread
+        std::string GetThreadName(std::thread::id id) const;
+
+        // Background threads
+        uint32_t GetBackgroundThreadCount() const { return m_thread_count_background.load(); }
+        void SetBackgroundThreadCount(uint32_t count);
+
+        // Statistics
+        TaskStats GetStats(TaskPriority priority) const;
+        void ResetStats();
 
     private:
-        // This function is invoked by the threads
-        void ThreadLoop();
+        // These functions are invoked by the threads
+        void ThreadLoop(uint32_t queue_index);
+        void ThreadLoopBackground(uint32_t index);
+
+        // Task scheduling
+        Task* AllocateTask();
+        void ReleaseTask(Task* task);
+        void Submit(Task* task);
+        Task* AcquireTask(uint32_t queue_index);
+        Task* AcquireTaskBackground();
+        bool HasQueuedTasks(bool background) const;
+        void ExecuteTask(Task* task);
+        template <typename Predicate> void WaitUntil(Predicate&& is_done);
+        void FlushLanes(bool remove_queued, bool background);
+        void NotifyWaiters();
 
         uint32_t m_thread_count         = 0;
         uint32_t m_thread_count_support = 0;
         std::vector<std::thread> m_threads;
-        std::deque<std::shared_ptr<Task>> m_tasks;
-        std::mutex m_mutex_tasks;
-        std::condition_variable m_condition_var;
         std::unordered_map<std::thread::id, std::string> m_thread_names;
-        bool m_stopping;
+        mutable std::mutex m_mutex_thread_names;
+
+        // One work-stealing queue per worker, plus one for the main thread (last), for critical and normal priorities
+        std::array<std::vector<std::unique_ptr<TaskQueue>>, 2> m_queues;
+        // Tasks submitted by threads which don't own a queue (and all background tasks)
+        std::array<std::deque<Task*>, task_priority_count> m_tasks_shared;
+        std::array<std::mutex, task_priority_count> m_mutex_tasks_shared;
+
+        // Background threads
+        std::vector<std::thread> m_threads_background;
+        std::atomic<uint32_t> m_thread_count_background = 0;
+        std::mutex m_mutex_threads_background;
+
+        // Per-thread task storage
+        std::vector<std::unique_ptr<TaskPool>> m_task_pools;
+        std::mutex m_mutex_task_pools;
+
+        // Task tracking
+        std::array<std::atomic<uint32_t>, task_priority_count> m_tasks_queued = {}; // waiting to be picked up
+        std::atomic<uint32_t> m_tasks_executing             = 0;                    // picked up and running (worker threads)
+        std::atomic<uint32_t> m_tasks_pending               = 0;                    // queued or executing (critical and normal)
+        std::atomic<uint32_t> m_tasks_pending_background    = 0;                    // queued or executing (background)
+
+        // Statistics
+        std::array<std::atomic<uint64_t>, task_priority_count> m_stats_executed     = {};
+        std::array<std::atomic<uint64_t>, task_priority_count> m_stats_wait_us      = {};
+        std::array<std::atomic<uint64_t>, task_priority_count> m_stats_wait_max_us  = {};
+
+        // Sleeping
+        std::mutex m_mutex_sleep;
+        std::condition_variable m_condition_var;
+        std::condition_variable m_condition_var_background;
+        std::atomic<uint32_t> m_threads_sleeping            = 0;
+        std::atomic<uint32_t> m_threads_sleeping_background = 0;
+        std::atomic<bool> m_stopping                        = false;
+
+        // Waiting (see Wait() and Flush())
+        std::mutex m_mutex_wait;
+        std::condition_variable m_condition_var_wait;
+        std::atomic<uint32_t> m_threads_waiting = 0;
+
+        // Coroutines waiting for the next frame
+        std::vector<std::coroutine_handle<>> m_coroutines_next_frame;
+        std::mutex m_mutex_coroutines_next_frame;
     };
 }
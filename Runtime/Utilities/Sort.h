@@ -0,0 +1,140 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+//= INCLUDES =====================
+#include <array>
+#include <vector>
+#include "../Threading/Threading.h"
+//================================
+
+namespace Spartan::Utility::Sort
+{
+    // Sorts values by their 64-bit keys (ascending and stable) with a least significant digit radix sort, 8 bits per pass.
+    // Passes over digits which are the same for every key are skipped, so keys which only use a few bits are cheap to sort.
+    // Arrays which are large enough are split into chunks which are counted and scattered in parallel.
+    template <typename T>
+    void Radix(std::vector<uint64_t>& keys, std::vector<T>& values, Threading* threading = nullptr)
+    {
+        constexpr uint32_t digit_count  = 8;
+        constexpr uint32_t bucket_count = 256;
+        constexpr uint32_t chunk_size   = 16384;
+
+        const uint32_t count = static_cast<uint32_t>(keys.size());
+        if (count <= 1)
+            return;
+
+        // Count every digit in a single pass, the counts don't depend on the order
+        std::array<std::array<uint32_t, bucket_count>, digit_count> histograms = {};
+        for (const uint64_t key : keys)
+        {
+            for (uint32_t digit = 0; digit < digit_count; digit++)
+            {
+                histograms[digit][(key >> (digit * 8)) & 0xFF]++;
+            }
+        }
+
+        // Referenced through locals, so that the tasks write to the scratch of the calling thread
+        static thread_local std::vector<uint64_t> t_keys_scratch;
+        static thread_local std::vector<T> t_values_scratch;
+        std::vector<uint64_t>& keys_scratch = t_keys_scratch;
+        std::vector<T>& values_scratch      = t_values_scratch;
+        keys_scratch.resize(count);
+        values_scratch.resize(count);
+
+        const uint32_t chunk_count = threading ? (count + chunk_size - 1) / chunk_size : 1;
+        std::vector<std::array<uint32_t, bucket_count>> offsets(chunk_count);
+
+        for (uint32_t digit = 0; digit < digit_count; digit++)
+        {
+            // Skip digits which are the same for every key
+            const uint32_t shift = digit * 8;
+            if (histograms[digit][(keys[0] >> shift) & 0xFF] == count)
+                continue;
+
+            if (chunk_count == 1)
+            {
+                // Exclusive prefix sum of the counts
+                uint32_t offset = 0;
+                for (uint32_t bucket = 0; bucket < bucket_count; bucket++)
+                {
+                    offsets[0][bucket]  = offset;
+                    offset             += histograms[digit][bucket];
+                }
+
+                for (uint32_t i = 0; i < count; i++)
+                {
+                    const uint32_t index    = offsets[0][(keys[i] >> shift) & 0xFF]++;
+                    keys_scratch[index]     = keys[i];
+                    values_scratch[index]   = std::move(values[i]);
+                }
+            }
+            else
+            {
+                // Count the digit in every chunk
+                threading->AddTaskLoop([&](const uint32_t start, const uint32_t end)
+                {
+                    for (uint32_t chunk = start; chunk < end; chunk++)
+                    {
+                        offsets[chunk].fill(0);
+                        const uint32_t last = std::min((chunk + 1) * chunk_size, count);
+                        for (uint32_t i = chunk * chunk_size; i < last; i++)
+                        {
+                            offsets[chunk][(keys[i] >> shift) & 0xFF]++;
+                        }
+                    }
+                }, chunk_count, 1);
+
+                // Exclusive prefix sum, bucket major and chunk minor, so that every chunk writes to its own part of each bucket
+                uint32_t offset = 0;
+                for (uint32_t bucket = 0; bucket < bucket_count; bucket++)
+                {
+                    for (uint32_t chunk = 0; chunk < chunk_count; chunk++)
+                    {
+                        const uint32_t chunk_bucket_count = offsets[chunk][bucket];
+                        offsets[chunk][bucket]  = offset;
+                        offset                 += chunk_bucket_count;
+                    }
+                }
+
+                // Scatter every chunk
+                threading->AddTaskLoop([&](const uint32_t start, const uint32_t end)
+                {
+                    for (uint32_t chunk = start; chunk < end; chunk++)
+                    {
+                        const uint32_t last = std::min((chunk + 1) * chunk_size, count);
+                        for (uint32_t i = chunk * chunk_size; i < last; i++)
+                        {
+                            const uint32_t index    = offsets[chunk][(keys[i] >> shift) & 0xFF]++;
+                            keys_scratch[index]     = keys[i];
+                            values_scratch[index]   = std::move(values[i]);
+                        }
+                    }
+                }, chunk_count, 1);
+            }
+
+            keys.swap(keys_scratch);
+            values.swap(values_scratch);
+        }
+    }
+}
@@ -0,0 +1,142 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ======
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+//=================
+
+namespace Spartan
+{
+    // Fixed size block allocator which carves blocks out of large chunks. Freed blocks are recycled
+    // via an intrusive free list, so objects of the same type end up next to each other in memory.
+    class ComponentPool
+    {
+    public:
+        ComponentPool(const size_t block_size, const size_t block_alignment)
+        {
+            m_block_alignment   = block_alignment < alignof(void*) ? alignof(void*) : block_alignment;
+            m_block_size        = (block_size < sizeof(void*) ? sizeof(void*) : block_size);
+            m_block_size        = (m_block_size + m_block_alignment - 1) & ~(m_block_alignment - 1);
+        }
+
+        ~ComponentPool()
+        {
+            for (std::byte* chunk : m_chunks)
+            {
+                ::operator delete(chunk, std::align_val_t(m_block_alignment));
+            }
+        }
+
+        ComponentPool(const ComponentPool&)             = delete;
+        ComponentPool& operator=(const ComponentPool&)  = delete;
+
+        void* Allocate()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (!m_free)
+            {
+                AllocateChunk();
+            }
+
+            void* block = m_free;
+            m_free      = *static_cast<void**>(m_free);
+            return block;
+        }
+
+        void Free(void* block)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            *static_cast<void**>(block) = m_free;
+            m_free = block;
+        }
+
+    private:
+        void AllocateChunk()
+        {
+            std::byte* chunk = static_cast<std::byte*>(::operator new(m_block_size * blocks_per_chunk, std::align_val_t(m_block_alignment)));
+            m_chunks.emplace_back(chunk);
+
+            // Link the blocks in address order, so that consecutive allocations are contiguous
+            for (size_t i = blocks_per_chunk; i-- > 0;)
+            {
+                void* block = chunk + i * m_block_size;
+                *static_cast<void**>(block) = m_free;
+                m_free = block;
+            }
+        }
+
+        static constexpr size_t blocks_per_chunk = 256;
+
+        size_t m_block_size         = 0;
+        size_t m_block_alignment    = 0;
+        void* m_free                = nullptr;
+        std::vector<std::byte*> m_chunks;
+        std::mutex m_mutex;
+    };
+
+    // Allocator for std::allocate_shared(), the component and its control block share a pool block
+    template <typename T>
+    class ComponentAllocator
+    {
+    public:
+        using value_type = T;
+
+        ComponentAllocator() = default;
+        template <typename U> ComponentAllocator(const ComponentAllocator<U>&) {}
+
+        T* allocate(const size_t count)
+        {
+            if (count != 1)
+                return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(alignof(T))));
+
+            return static_cast<T*>(GetPool().Allocate());
+        }
+
+        void deallocate(T* pointer, const size_t count)
+        {
+            if (count != 1)
+            {
+                ::operator delete(pointer, std::align_val_t(alignof(T)));
+                return;
+            }
+
+            GetPool().Free(pointer);
+        }
+
+        template <typename U> bool operator==(const ComponentAllocator<U>&) const { return true; }
+        template <typename U> bool operator!=(const ComponentAllocator<U>&) const { return false; }
+
+    private:
+        static ComponentPool& GetPool()
+        {
+            static ComponentPool pool(sizeof(T), alignof(T));
+            return pool;
+        }
+    };
+}
@@ -126,6 +126,7 @@ namespace Spartan
         {
             // In order for the component to guarantee serialization/deserialization, we cache the audio clip
             m_audio_clip = m_context->GetSubsystem<ResourceCache>()->Cache(audio_clip);
+            MarkModified();
         }
     }
 
@@ -163,6 +164,7 @@ namespace Spartan
             return;
     
         m_mute = mute;
+        MarkModified();
         m_audio_clip->SetMute(mute);
     }
     
@@ -174,6 +176,7 @@ namespace Spartan
         // Priority for the channel, from 0 (most important) 
         // to 256 (least important), default = 128.
         m_priority = static_cast<int>(Helper::Clamp(priority, 0, 255));
+        MarkModified();
         m_audio_clip->SetPriority(m_priority);
     }
     
@@ -183,6 +186,7 @@ namespace Spartan
             return;
     
         m_volume = Helper::Clamp(volume, 0.0f, 1.0f);
+        MarkModified();
         m_audio_clip->SetVolume(m_volume);
     }
     
@@ -192,6 +196,7 @@ namespace Spartan
             return;
     
         m_pitch = Helper::Clamp(pitch, 0.0f, 3.0f);
+        MarkModified();
         m_audio_clip->SetPitch(m_pitch);
     }
     
@@ -202,6 +207,7 @@ namespace Spartan
     
         // Pan level, from -1.0 (left) to 1.0 (right).
         m_pan = Helper::Clamp(pan, -1.0f, 1.0f);
+        MarkModified();
         m_audio_clip->SetPan(m_pan);
     }
 }
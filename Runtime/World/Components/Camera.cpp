@@ -49,6 +49,7 @@ namespace Spartan
         m_view              = ComputeViewMatrix();
         m_projection        = ComputeProjection(m_renderer->GetOption(Render_ReverseZ));
         m_view_projection   = m_view * m_projection;
+        m_version++;
     }
 
     void Camera::OnTick(float delta_time)
@@ -61,11 +62,10 @@ namespace Spartan
         }
 
         // DIRTY CHECK
-        if (m_position != GetTransform()->GetPosition() || m_rotation != GetTransform()->GetRotation())
+        if (m_transform_version != GetTransform()->GetVersion())
         {
-            m_position = GetTransform()->GetPosition();
-            m_rotation = GetTransform()->GetRotation();
-            m_is_dirty = true;
+            m_transform_version = GetTransform()->GetVersion();
+            m_is_dirty          = true;
         }
 
         if (m_fps_control)
@@ -82,6 +82,7 @@ namespace Spartan
         m_frustrum          = Frustum(GetViewMatrix(), GetProjectionMatrix(), m_renderer->GetOption(Render_ReverseZ) ? GetNearPlane() : GetFarPlane());
 
         m_is_dirty = false;
+        m_version++;
     }
 
     void Camera::Serialize(FileStream* stream)
@@ -110,24 +111,28 @@ namespace Spartan
         m_view              = ComputeViewMatrix();
         m_projection        = ComputeProjection(m_renderer->GetOption(Render_ReverseZ));
         m_view_projection   = m_view * m_projection;
+        m_version++;
     }
 
     void Camera::SetNearPlane(const float near_plane)
     {
         m_near_plane = Helper::Max(0.01f, near_plane);
         m_is_dirty = true;
+        MarkModified();
     }
 
     void Camera::SetFarPlane(const float far_plane)
     {
         m_far_plane = far_plane;
         m_is_dirty = true;
+        MarkModified();
     }
 
     void Camera::SetProjection(const ProjectionType projection)
     {
         m_projection_type = projection;
         m_is_dirty = true;
+        MarkModified();
     }
 
     float Camera::GetFovHorizontalDeg() const
@@ -144,6 +149,7 @@ namespace Spartan
     {
         m_fov_horizontal_rad = Helper::DegreesToRadians(fov);
         m_is_dirty = true;
+        MarkModified();
     }
 
     const RHI_Viewport& Camera::GetViewport() const
@@ -182,33 +188,18 @@ namespace Spartan
         Vector3 ray_end     = Unproject(mouse_position_relative);
         m_ray               = Ray(ray_start, ray_end);
 
-        // Traces ray against all AABBs in the world
+        // Traces ray against the AABBs in the world, the spatial index only visits the ones along the ray
         vector<RayHit> hits;
         {
-            const auto& entities = m_context->GetSubsystem<World>()->EntityGetAll();
-            for (const auto& entity : entities)
+            m_context->GetSubsystem<World>()->SpatialQueryRay(m_ray, [this, &hits](Entity* entity, const float distance)
             {
-                // Make sure there entity has a renderable
-                if (!entity->HasComponent<Renderable>())
-                    continue;
-
-                // Get object oriented bounding box
-                const BoundingBox& aabb = entity->GetComponent<Renderable>()->GetAabb();
-
-                // Compute hit distance
-                float distance = m_ray.HitDistance(aabb);
-
-                // Don't store hit data if there was no hit
-                if (distance == Helper::INFINITY_)
-                    continue;
-
                 hits.emplace_back(
-                    entity,                                             // Entity
+                    entity->GetPtrShared(),                             // Entity
                     m_ray.GetStart() + distance * m_ray.GetDirection(), // Position
                     distance,                                           // Distance
                     distance == 0.0f                                    // Inside
                 );
-            }
+            });
 
             // Sort by distance (ascending)
             std::sort(hits.begin(), hits.end(), [](const RayHit& a, const RayHit& b) { return a.m_distance < b.m_distance; });
@@ -64,6 +64,8 @@ namespace Spartan
         const Math::Matrix& GetViewMatrix()             const { return m_view; }
         const Math::Matrix& GetProjectionMatrix()       const { return m_projection; }
         const Math::Matrix& GetViewProjectionMatrix()   const { return m_view_projection; }
+        // Incremented every time the matrices are recomputed
+        uint64_t GetVersion()                           const { return m_version; }
         //=================================================================================
 
         //= RAYCASTING =================================================================
@@ -84,13 +86,13 @@ namespace Spartan
         //==============================================================================
 
         float GetAperture() const { return m_aperture; }
-        void SetAperture(const float aperture) { m_aperture = aperture; }
+        void SetAperture(const float aperture) { m_aperture = aperture; MarkModified(); }
 
         float GetShutterSpeed() const                   { return m_shutter_speed; }
-        void SetShutterSpeed(const float shutter_speed) { m_shutter_speed = shutter_speed; }
+        void SetShutterSpeed(const float shutter_speed) { m_shutter_speed = shutter_speed; MarkModified(); }
 
         float GetIso() const            { return m_iso; }
-        void SetIso(const float iso)    { m_iso = iso; }
+        void SetIso(const float iso)    { m_iso = iso; MarkModified(); }
 
         float GetEv100()    const { return std::log2((m_aperture * m_aperture) / m_shutter_speed * 100.0f / m_iso);} // Reference: https://google.github.io/filament/Filament.md.html#lighting/units/lightunitsvalidation
         float GetExposure() const { return 1.0f / (std::pow(2.0f, GetEv100()) * 1.2f); } // Frostbite: https://seblagarde.files.wordpress.com/2015/07/course_notes_moving_frostbite_to_pbr_v32.pdf
@@ -115,8 +117,9 @@ namespace Spartan
         //= MISC ==============================================================================
         bool IsInViewFrustrum(Renderable* renderable) const;
         bool IsInViewFrustrum(const Math::Vector3& center, const Math::Vector3& extents) const;
+        const Math::Frustum& GetFrustum()               const { return m_frustrum; }
         const Math::Vector4& GetClearColor() const            { return m_clear_color; }
-        void SetClearColor(const Math::Vector4& color)        { m_clear_color = color; }
+        void SetClearColor(const Math::Vector4& color)        { m_clear_color = color; MarkModified(); }
         bool GetFpsControl()                            const { return m_fps_control; }
         void SetFpsControl(const bool fps_control)            { m_fps_control = fps_control; }
         //=====================================================================================
@@ -138,8 +141,8 @@ namespace Spartan
         Math::Matrix m_view                 = Math::Matrix::Identity;
         Math::Matrix m_projection           = Math::Matrix::Identity;
         Math::Matrix m_view_projection      = Math::Matrix::Identity;
-        Math::Vector3 m_position            = Math::Vector3::Zero;
-        Math::Quaternion m_rotation         = Math::Quaternion::Identity;
+        uint64_t m_transform_version        = 0;
+        uint64_t m_version                  = 0;
         bool m_is_dirty                     = false;
         bool m_fps_control                  = true;
         bool m_fps_control_assumed          = false;
@@ -94,6 +94,7 @@ namespace Spartan
         m_size.x = Helper::Clamp(m_size.x, Helper::EPSILON, INFINITY);
         m_size.y = Helper::Clamp(m_size.y, Helper::EPSILON, INFINITY);
         m_size.z = Helper::Clamp(m_size.z, Helper::EPSILON, INFINITY);
+        MarkModified();
 
         Shape_Update();
     }
@@ -104,6 +105,7 @@ namespace Spartan
             return;
 
         m_center = center;
+        MarkModified();
         RigidBody_SetCenterOfMass(m_center);
     }
 
@@ -113,6 +115,7 @@ namespace Spartan
             return;
 
         m_shapeType = type;
+        MarkModified();
         Shape_Update();
     }
 
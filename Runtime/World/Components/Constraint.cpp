@@ -123,6 +123,7 @@ namespace Spartan
         if (m_constraintType != type || !m_constraint)
         {
             m_constraintType = type;
+            MarkModified();
             Construct();
         }
     }
@@ -132,6 +133,7 @@ namespace Spartan
         if (m_position != position)
         {
             m_position = position;
+            MarkModified();
             ApplyFrames();
         }
     }
@@ -141,6 +143,7 @@ namespace Spartan
         if (m_rotation != rotation)
         {
             m_rotation = rotation;
+            MarkModified();
             ApplyFrames();
         }
     }
@@ -175,6 +178,7 @@ namespace Spartan
         }
 
         m_bodyOther = body_other;
+        MarkModified();
         Construct();
     }
 
@@ -183,6 +187,7 @@ namespace Spartan
         if (m_highLimit != limit)
         {
             m_highLimit = limit;
+            MarkModified();
             ApplyLimits();
         }
     }
@@ -192,6 +197,7 @@ namespace Spartan
         if (m_lowLimit != limit)
         {
             m_lowLimit = limit;
+            MarkModified();
             ApplyLimits();
         }
     }
@@ -66,7 +66,7 @@ namespace Spartan
         if (!m_is_dirty)
             return;
 
-        m_context->GetSubsystem<Threading>()->AddTask([this]
+        m_context->GetSubsystem<Threading>()->AddTaskBackground([this]
         {
             SetFromTextureSphere(m_file_paths.front());
         });
@@ -85,7 +85,7 @@ namespace Spartan
         m_environment_type = static_cast<Environment_Type>(stream->ReadAs<uint8_t>());
         stream->Read(&m_file_paths);
 
-        m_context->GetSubsystem<Threading>()->AddTask([this]
+        m_context->GetSubsystem<Threading>()->AddTaskBackground([this]
         {
             if (m_environment_type == Enviroment_Cubemap)
             {
@@ -115,7 +115,12 @@ namespace Spartan
         m_context->GetSubsystem<Renderer>()->SetEnvironmentTexture(texture);
 
         // Save file path for serialization/deserialization
-        m_file_paths = { texture ? texture->GetResourceFilePath() : "" };
+        vector<string> file_paths = { texture ? texture->GetResourceFilePath() : "" };
+        if (file_paths != m_file_paths)
+        {
+            m_file_paths = move(file_paths);
+            MarkModified();
+        }
     }
 
     void Environment::SetFromTextureArray(const vector<string>& file_paths)
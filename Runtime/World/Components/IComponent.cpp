@@ -60,6 +60,14 @@ namespace Spartan
         return m_entity->GetName();
     }
 
+    void IComponent::MarkModified()
+    {
+        if (m_entity)
+        {
+            m_entity->SetModified(true);
+        }
+    }
+
     template <typename T>
     inline constexpr ComponentType IComponent::TypeToEnum() { return ComponentType::Unknown; }
 
@@ -54,6 +54,7 @@ namespace Spartan
         Terrain,
         Unknown
     };
+    constexpr uint32_t component_type_count = static_cast<uint32_t>(ComponentType::Unknown);
 
     struct Attribute
     {
@@ -117,6 +118,9 @@ namespace Spartan
         //=======================================================================================
 
     protected:
+        // Marks the entity as modified, setters of serialized data call this so that the hierarchy is serialized again on the next save
+        void MarkModified();
+
         #define REGISTER_ATTRIBUTE_GET_SET(getter, setter, type) RegisterAttribute(     \
         [this]()                        { return getter(); },                           \
         [this](const std::any& valueIn) { setter(std::any_cast<type>(valueIn)); });     \
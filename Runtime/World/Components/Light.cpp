@@ -83,12 +83,10 @@ namespace Spartan
         }
 
         // Position and rotation dirty check
-        if (m_previous_pos != GetTransform()->GetPosition() || m_previous_rot != GetTransform()->GetRotation())
+        if (m_transform_version != GetTransform()->GetVersion())
         {
-            m_previous_pos = GetTransform()->GetPosition();
-            m_previous_rot = GetTransform()->GetRotation();
-
-            m_is_dirty = true;
+            m_transform_version = GetTransform()->GetVersion();
+            m_is_dirty          = true;
         }
 
         // Camera dirty check (needed for directional light cascade computations)
@@ -96,10 +94,11 @@ namespace Spartan
         {
             if (auto& camera = m_renderer->GetCamera())
             {
-                if (m_previous_camera_view != camera->GetViewMatrix())
+                if (m_camera != camera.get() || m_camera_version != camera->GetVersion())
                 {
-                    m_previous_camera_view = camera->GetViewMatrix();
-                    m_is_dirty = true;
+                    m_camera            = camera.get();
+                    m_camera_version    = camera->GetVersion();
+                    m_is_dirty          = true;
                 }
             }
         }
@@ -167,6 +166,7 @@ namespace Spartan
 
         m_light_type    = type;
         m_is_dirty      = true;
+        MarkModified();
 
         if (m_shadows_enabled)
         {
@@ -189,6 +189,7 @@ namespace Spartan
 
         m_shadows_enabled   = cast_shadows;
         m_is_dirty          = true;
+        MarkModified();
 
         if (m_shadows_enabled)
         {
@@ -202,6 +203,7 @@ namespace Spartan
             return;
 
         m_shadows_transparent_enabled = cast_transparent_shadows;
+        MarkModified();
 
         if (m_shadows_transparent_enabled)
         {
@@ -213,12 +215,14 @@ namespace Spartan
     {
         m_range = Helper::Clamp(range, 0.0f, std::numeric_limits<float>::max());
         m_is_dirty = true;
+        MarkModified();
     }
 
     void Light::SetAngle(float angle)
     {
         m_angle_rad = Helper::Clamp(angle, 0.0f, Helper::PI_2);
         m_is_dirty  = true;
+        MarkModified();
     }
 
     void Light::SetTimeOfDay(float time_of_day)
@@ -497,9 +501,6 @@ namespace Spartan
         const auto center       = box.GetCenter();
         const auto extents      = box.GetExtents();
 
-        // ensure that potential shadow casters from behind the near plane are not rejected
-        const bool ignore_near_plane = (m_light_type == LightType::Directional) ? true : false;
-
-        return m_shadow_map.slices[index].frustum.IsVisible(center, extents, ignore_near_plane);
+        return m_shadow_map.slices[index].frustum.IsVisible(center, extents, GetFrustumIgnoresNearPlane());
     }
 }  
@@ -78,23 +78,23 @@ namespace Spartan
         void SetLightType(LightType type);
 
         void SetColor(const float temperature);
-        void SetColor(const Math::Vector4& rgb) { m_color_rgb = rgb; }
+        void SetColor(const Math::Vector4& rgb) { m_color_rgb = rgb; MarkModified(); }
         const auto& GetColor() const            { return m_color_rgb; }
 
-        void SetIntensity(float value)  { m_intensity = value; }
+        void SetIntensity(float value)  { m_intensity = value; MarkModified(); }
         auto GetIntensity()    const    { return m_intensity; }
 
         bool GetShadowsEnabled() const { return m_shadows_enabled; }
         void SetShadowsEnabled(bool cast_shadows);
 
         bool GetShadowsScreenSpaceEnabled() const                      { return m_shadows_screen_space_enabled; }
-        void SetShadowsScreenSpaceEnabled(bool cast_contact_shadows)   { m_shadows_screen_space_enabled = cast_contact_shadows; }
+        void SetShadowsScreenSpaceEnabled(bool cast_contact_shadows)   { m_shadows_screen_space_enabled = cast_contact_shadows; MarkModified(); }
 
         bool GetShadowsTransparentEnabled() const { return m_shadows_transparent_enabled; }
         void SetShadowsTransparentEnabled(bool cast_transparent_shadows);
 
         bool GetVolumetricEnabled() const               { return m_volumetric_enabled; }
-        void SetVolumetricEnabled(bool is_volumetric)   { m_volumetric_enabled = is_volumetric; }
+        void SetVolumetricEnabled(bool is_volumetric)   { m_volumetric_enabled = is_volumetric; MarkModified(); }
 
         void SetRange(float range);
         auto GetRange() const { return m_range; }
@@ -105,10 +105,10 @@ namespace Spartan
         void SetTimeOfDay(float time_of_day);
         auto GetTimeOfDay() const { return m_time_of_day; }
 
-        void SetBias(float value)   { m_bias = value; }
+        void SetBias(float value)   { m_bias = value; MarkModified(); }
         float GetBias() const       { return m_bias; }
 
-        void SetNormalBias(float value) { m_normal_bias = value; }
+        void SetNormalBias(float value) { m_normal_bias = value; MarkModified(); }
         auto GetNormalBias() const { return m_normal_bias; }
 
         Math::Vector3 GetDirection() const;
@@ -122,6 +122,9 @@ namespace Spartan
         void CreateShadowMap();
 
         bool IsInViewFrustrum(Renderable* renderable, uint32_t index) const;
+        const Math::Frustum& GetFrustum(uint32_t index) const { return m_shadow_map.slices[index].frustum; }
+        // Ensures that potential shadow casters from behind the near plane are not rejected
+        bool GetFrustumIgnoresNearPlane() const { return m_light_type == LightType::Directional; }
 
     private:
         void ComputeViewMatrix();
@@ -151,9 +154,9 @@ namespace Spartan
         bool m_is_dirty             = true;
         std::array<Math::Matrix, 6> m_matrix_view;
         std::array<Math::Matrix, 6> m_matrix_projection;
-        Math::Quaternion m_previous_rot     = Math::Quaternion::Identity;
-        Math::Vector3 m_previous_pos        = Math::Vector3::Infinity;
-        Math::Matrix m_previous_camera_view = Math::Matrix::Identity;
+        uint64_t m_transform_version        = 0;
+        const Camera* m_camera              = nullptr;
+        uint64_t m_camera_version           = 0;
         Renderer* m_renderer;
     };
 }
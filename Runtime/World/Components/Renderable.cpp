@@ -23,6 +23,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Spartan.h"
 #include "Renderable.h"
 #include "Transform.h"
+#include "../Entity.h"
+#include "../World.h"
 #include "../../IO/FileStream.h"
 #include "../../Resource/ResourceCache.h"
 #include "../../Utilities/Geometry.h"
@@ -113,6 +115,17 @@ namespace Spartan
         REGISTER_ATTRIBUTE_GET_SET(Geometry_Type, GeometrySet,  Geometry_Type);
     }
 
+    void Renderable::OnRemove()
+    {
+        if (m_spatial_proxy == spatial_proxy_invalid)
+            return;
+
+        if (World* world = m_context->GetSubsystem<World>())
+        {
+            world->SpatialIndexRemove(this);
+        }
+    }
+
     void Renderable::Serialize(FileStream* stream)
     {
         // Mesh
@@ -142,6 +155,8 @@ namespace Spartan
         m_geometryVertexOffset  = stream->ReadAs<uint32_t>();
         m_geometryVertexCount   = stream->ReadAs<uint32_t>();
         stream->Read(&m_bounding_box);
+        m_transform_version = 0;
+        m_spatial_version   = 0;
         string model_name;
         stream->Read(&model_name);
         m_model = m_context->GetSubsystem<ResourceCache>()->GetByName<Model>(model_name).get();
@@ -182,11 +197,15 @@ namespace Spartan
         m_geometryVertexCount   = vertex_count;
         m_bounding_box          = bounding_box;
         m_model                 = model;
+        m_transform_version     = 0;
+        m_spatial_version       = 0;
+        MarkModified();
     }
 
     void Renderable::GeometrySet(const Geometry_Type type)
     {
         m_geometry_type = type;
+        MarkModified();
 
         if (type != Geometry_Custom)
         {
@@ -213,10 +232,10 @@ namespace Spartan
     const BoundingBox& Renderable::GetAabb()
     {
         // Updated if dirty
-        if (m_last_transform != GetTransform()->GetMatrix() || !m_aabb.Defined())
+        if (m_transform_version != GetTransform()->GetVersion() || !m_aabb.Defined())
         {
-            m_aabb = m_bounding_box.Transform(GetTransform()->GetMatrix());
-            m_last_transform = GetTransform()->GetMatrix();
+            m_aabb              = m_bounding_box.Transform(GetTransform()->GetMatrix());
+            m_transform_version = GetTransform()->GetVersion();
         }
 
         return m_aabb;
@@ -239,6 +258,11 @@ namespace Spartan
         // Set to false otherwise material won't serialize/deserialize
         m_material_default = false;
 
+        MarkModified();
+
+        // The new material might be transparent while the previous wasn't (or vice versa)
+        m_context->GetSubsystem<World>()->EntityChanged(m_entity);
+
         return _material;
     }
 
@@ -277,6 +301,12 @@ namespace Spartan
         m_material_default = true;
     }
 
+    void Renderable::SetCastShadows(const bool cast_shadows)
+    {
+        m_cast_shadows = cast_shadows;
+        MarkModified();
+    }
+
     string Renderable::GetMaterialName() const
     {
         return m_material ? m_material->GetResourceName() : "";
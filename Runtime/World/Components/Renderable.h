@@ -56,6 +56,7 @@ namespace Spartan
         ~Renderable() = default;
 
         //= ICOMPONENT ===============================
+        void OnRemove() override;
         void Serialize(FileStream* stream) override;
         void Deserialize(FileStream* stream) override;
         //============================================
@@ -98,10 +99,16 @@ namespace Spartan
         //===============================================================================
 
         //= PROPERTIES ===================================================================
-        void SetCastShadows(const bool cast_shadows)    { m_cast_shadows = cast_shadows; }
+        void SetCastShadows(const bool cast_shadows);
         auto GetCastShadows() const                     { return m_cast_shadows; }
         //================================================================================
 
+        // Location in the world's spatial index and the transform version it was indexed with (managed by the world)
+        static constexpr uint32_t spatial_proxy_invalid = std::numeric_limits<uint32_t>::max();
+        uint32_t GetSpatialProxy() const                                    { return m_spatial_proxy; }
+        uint64_t GetSpatialVersion() const                                  { return m_spatial_version; }
+        void SetSpatialProxy(const uint32_t proxy, const uint64_t version)  { m_spatial_proxy = proxy; m_spatial_version = version; }
+
     private:
         std::string m_geometryName;
         uint32_t m_geometryIndexOffset;
@@ -111,7 +118,9 @@ namespace Spartan
         Geometry_Type m_geometry_type;
         Math::BoundingBox m_bounding_box;
         Math::BoundingBox m_aabb;
-        Math::Matrix m_last_transform   = Math::Matrix::Identity;
+        uint64_t m_transform_version    = 0; // the transform version m_aabb was computed with, 0 forces an update
+        uint32_t m_spatial_proxy        = spatial_proxy_invalid;
+        uint64_t m_spatial_version      = 0; // 0 forces an update
         bool m_cast_shadows             = true;
         bool m_material_default;
         Model* m_model          = nullptr;
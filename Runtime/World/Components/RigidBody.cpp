@@ -127,6 +127,12 @@ namespace Spartan
         // When the rigid body is inactive or we are in editor mode, allow the user to move/rotate it
         if (!IsActivated() || !m_context->m_engine->EngineMode_IsSet(Engine_Game))
         {
+            // Only compare against the body when the transform has actually changed
+            if (m_transform_version == GetTransform()->GetVersion())
+                return;
+
+            m_transform_version = GetTransform()->GetVersion();
+
             if (GetPosition() != GetTransform()->GetPosition())
             {
                 SetPosition(GetTransform()->GetPosition(), false);
@@ -180,6 +186,7 @@ namespace Spartan
         if (mass != m_mass)
         {
             m_mass = mass;
+            MarkModified();
             Body_AddToWorld();
         }
     }
@@ -190,6 +197,7 @@ namespace Spartan
             return;
 
         m_friction = friction;
+        MarkModified();
         m_rigidBody->setFriction(friction);
     }
 
@@ -199,6 +207,7 @@ namespace Spartan
             return;
 
         m_friction_rolling = frictionRolling;
+        MarkModified();
         m_rigidBody->setRollingFriction(frictionRolling);
     }
 
@@ -208,6 +217,7 @@ namespace Spartan
             return;
 
         m_restitution = restitution;
+        MarkModified();
         m_rigidBody->setRestitution(restitution);
     }
 
@@ -217,6 +227,7 @@ namespace Spartan
             return;
 
         m_use_gravity = gravity;
+        MarkModified();
         Body_AddToWorld();
     }
 
@@ -226,6 +237,7 @@ namespace Spartan
             return;
 
         m_gravity = acceleration;
+        MarkModified();
         Body_AddToWorld();
     }
 
@@ -235,6 +247,7 @@ namespace Spartan
             return;
 
         m_is_kinematic = kinematic;
+        MarkModified();
         Body_AddToWorld();
     }
 
@@ -331,6 +344,7 @@ namespace Spartan
             return;
 
         m_position_lock = lock;
+        MarkModified();
         m_rigidBody->setLinearFactor(ToBtVector3(Vector3::One - lock));
     }
 
@@ -352,6 +366,7 @@ namespace Spartan
             return;
 
         m_rotation_lock = lock;
+        MarkModified();
         m_rigidBody->setAngularFactor(ToBtVector3(Vector3::One - lock));
     }
 
@@ -481,6 +496,7 @@ namespace Spartan
     void RigidBody::SetShape(btCollisionShape* shape)
     {
         m_collision_shape = shape;
+        MarkModified();
 
         if (m_collision_shape)
         {
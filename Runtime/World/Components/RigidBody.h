@@ -161,6 +161,7 @@ namespace Spartan
         btRigidBody* m_rigidBody            = nullptr;
         btCollisionShape* m_collision_shape = nullptr;
         bool m_in_world                     = false;
+        uint64_t m_transform_version        = 0;
         Physics* m_physics                  = nullptr;
         std::vector<Constraint*> m_constraints;
     };
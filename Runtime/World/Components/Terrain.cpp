@@ -75,11 +75,12 @@ namespace Spartan
     {
         // In order for the component to guarantee serialization/deserialization, we cache the height_map
         m_height_map = m_context->GetSubsystem<ResourceCache>()->Cache<RHI_Texture2D>(height_map);
+        MarkModified();
     }
 
     void Terrain::GenerateAsync()
     {
-        if (m_is_generating)
+        if (!m_generation.IsDone())
         {
             LOG_WARNING("Terrain is already being generated, please wait...");
             return;
@@ -91,6 +92,7 @@ namespace Spartan
 
             m_context->GetSubsystem<ResourceCache>()->Remove(m_model);
             m_model.reset();
+            MarkModified();
             if (Renderable* renderable = m_entity->AddComponent<Renderable>())
             {
                 renderable->GeometryClear();
@@ -99,58 +101,75 @@ namespace Spartan
             return;
         }
 
-        m_context->GetSubsystem<Threading>()->AddTask([this]()
-        {
-            m_is_generating = true;
+        m_generation = Generate();
+        m_generation.Start(m_context->GetSubsystem<Threading>(), TaskPriority::Background);
+    }
 
-            // Get height map data
-            const vector<std::byte> height_map_data = m_height_map->GetOrLoadMip(0);
-            if (height_map_data.empty())
+    AsyncTask<> Terrain::Generate()
+    {
+        Threading* threading = m_context->GetSubsystem<Threading>();
+
+        // Get height map data, if it's not in memory, the coroutine is suspended while the file is read (instead of blocking a thread)
+        vector<std::byte> height_map_data;
+        if (m_height_map->HasData())
+        {
+            height_map_data = m_height_map->GetOrLoadMip(0);
+        }
+        else
+        {
+            vector<std::byte> file_data = co_await AwaitFileRead(threading, m_height_map->GetResourceFilePathNative());
+            if (!file_data.empty())
             {
-                LOG_ERROR("Height map has no data");
+                height_map_data = m_height_map->GetOrLoadMip(0, &file_data);
             }
+        }
 
-            // Deduce some stuff
-            m_height                            = m_height_map->GetHeight();
-            m_width                             = m_height_map->GetWidth();
-            m_vertex_count                      = m_height * m_width;
-            m_face_count                        = (m_height - 1) * (m_width - 1) * 2;
-            m_progress_jobs_done                = 0;
-            m_progress_job_count                = m_vertex_count * 2 + m_face_count + m_vertex_count * m_face_count;
-
-            // Pre-allocate memory for the calculations that follow
-            vector<Vector3> positions                 = vector<Vector3>(m_height * m_width);
-            vector<RHI_Vertex_PosTexNorTan> vertices  = vector<RHI_Vertex_PosTexNorTan>(m_vertex_count);
-            vector<uint32_t> indices                  = vector<uint32_t>(m_face_count * 3);
-
-            // Read height map and construct positions
-            m_progress_desc = "Generating positions...";
-            if (GeneratePositions(positions, height_map_data))
+        if (height_map_data.empty())
+        {
+            LOG_ERROR("Height map has no data");
+        }
+
+        // Deduce some stuff
+        m_height                            = m_height_map->GetHeight();
+        m_width                             = m_height_map->GetWidth();
+        m_vertex_count                      = m_height * m_width;
+        m_face_count                        = (m_height - 1) * (m_width - 1) * 2;
+        m_progress_jobs_done                = 0;
+        m_progress_job_count                = m_vertex_count * 2 + m_face_count + m_vertex_count * m_face_count;
+
+        // Pre-allocate memory for the calculations that follow
+        vector<Vector3> positions                 = vector<Vector3>(m_height * m_width);
+        vector<RHI_Vertex_PosTexNorTan> vertices  = vector<RHI_Vertex_PosTexNorTan>(m_vertex_count);
+        vector<uint32_t> indices                  = vector<uint32_t>(m_face_count * 3);
+
+        // Read height map and construct positions
+        m_progress_desc = "Generating positions...";
+        if (GeneratePositions(positions, height_map_data))
+        {
+            // Compute the vertices (without the normals) and the indices
+            m_progress_desc = "Generating terrain vertices and indices...";
+            if (GenerateVerticesIndices(positions, indices, vertices))
             {
-                // Compute the vertices (without the normals) and the indices
-                m_progress_desc = "Generating terrain vertices and indices...";
-                if (GenerateVerticesIndices(positions, indices, vertices))
-                {
-                    m_progress_desc = "Generating normals and tangents...";
-                    positions.clear();
-                    positions.shrink_to_fit();
+                m_progress_desc = "Generating normals and tangents...";
+                positions.clear();
+                positions.shrink_to_fit();
 
-                    // Compute the normals by doing normal averaging (very expensive)
-                    if (GenerateNormalTangents(indices, vertices))
-                    {
-                        // Create a model and set it to the renderable component
-                        UpdateFromVertices(indices, vertices);
-                    }
+                // Compute the normals by doing normal averaging (very expensive)
+                if (GenerateNormalTangents(indices, vertices))
+                {
+                    // Create a model and set it to the renderable component, on the main thread so that the world doesn't change mid-frame
+                    co_await AwaitNextFrame(threading);
+                    UpdateFromVertices(indices, vertices);
                 }
             }
+        }
 
-            // Clear progress stats
-            m_progress_jobs_done = 0;
-            m_progress_job_count = 1;
-            m_progress_desc.clear();
+        // Clear progress stats
+        m_progress_jobs_done = 0;
+        m_progress_job_count = 1;
+        m_progress_desc.clear();
 
-            m_is_generating = false;
-        });
+        co_return;
     }
 
     bool Terrain::GeneratePositions(vector<Vector3>& positions, const vector<std::byte>& height_map)
@@ -375,7 +394,7 @@ namespace Spartan
             }
         };
 
-        m_context->GetSubsystem<Threading>()->AddTaskLoop(compute_vertex_normals_tangents, vertex_count);
+        m_context->GetSubsystem<Threading>()->AddTaskLoop(compute_vertex_normals_tangents, vertex_count, 0, TaskPriority::Background);
 
         return true;
     }
@@ -430,5 +449,6 @@ namespace Spartan
         }
 
         UpdateFromModel(m_model);
+        MarkModified();
     }
 }
@@ -25,6 +25,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "IComponent.h"
 #include <atomic>
 #include "../../RHI/RHI_Definition.h"
+#include "../../Threading/AsyncTask.h"
 //===================================
 
 namespace Spartan
@@ -51,10 +52,10 @@ namespace Spartan
         void SetHeightMap(const std::shared_ptr<RHI_Texture2D>& height_map);
 
         float GetMinY() const { return m_min_y; }
-        void SetMinY(float min_z)   { m_min_y = min_z; }
+        void SetMinY(float min_z)   { m_min_y = min_z; MarkModified(); }
 
         float GetMaxY() const { return m_max_y; }
-        void SetMaxY(float max_z)   { m_max_y = max_z; }
+        void SetMaxY(float max_z)   { m_max_y = max_z; MarkModified(); }
 
         float GetProgress() const { return static_cast<float>(static_cast<double>(m_progress_jobs_done) / static_cast<double>(m_progress_job_count)); }
         const auto& GetProgressDescription() const { return m_progress_desc; }
@@ -62,6 +63,7 @@ namespace Spartan
         void GenerateAsync();
 
     private:
+        AsyncTask<> Generate();
         bool GeneratePositions(std::vector<Math::Vector3>& positions, const std::vector<std::byte>& height_map);
         bool GenerateVerticesIndices(const std::vector<Math::Vector3>& positions, std::vector<uint32_t>& indices, std::vector<RHI_Vertex_PosTexNorTan>& vertices);
         bool GenerateNormalTangents(const std::vector<uint32_t>& indices, std::vector<RHI_Vertex_PosTexNorTan>& vertices);
@@ -73,7 +75,6 @@ namespace Spartan
         float m_min_y                               = 0.0f;
         float m_max_y                               = 30.0f;
         float m_vertex_density                      = 1.0f;
-        bool m_is_generating                        = false;
         uint64_t m_vertex_count                     = 0;
         uint64_t m_face_count                       = 0;
         std::atomic<uint64_t> m_progress_jobs_done  = 0;
@@ -81,5 +82,6 @@ namespace Spartan
         std::string m_progress_desc;
         std::shared_ptr<RHI_Texture2D> m_height_map;
         std::shared_ptr<Model> m_model;
+        AsyncTask<> m_generation;
     };
 }
@@ -54,7 +54,7 @@ namespace Spartan
 
     void Transform::OnInitialize()
     {
-        UpdateTransform();
+        MarkDirty();
     }
 
     void Transform::Serialize(FileStream* stream)
@@ -83,15 +83,57 @@ namespace Spartan
             }
         }
 
-        UpdateTransform();
+        MarkDirty();
     }
 
     void Transform::UpdateTransform()
+    {
+        MarkDirty();
+        ComputeMatrices();
+    }
+
+    void Transform::UpdateHierarchy()
+    {
+        // Keep walking even if this transform is up to date, it could have been resolved on demand before its descendants
+        Resolve();
+
+        for (Transform* child : m_children)
+        {
+            child->UpdateHierarchy();
+        }
+    }
+
+    void Transform::MarkDirty()
+    {
+        MarkModified();
+
+        // If this transform is already dirty, so are its descendants (and the world already knows about it)
+        if (m_is_dirty)
+            return;
+
+        GetContext()->GetSubsystem<World>()->TransformDirty(this);
+        MarkDirtyDescendants();
+    }
+
+    void Transform::MarkDirtyDescendants()
+    {
+        m_is_dirty = true;
+
+        for (Transform* child : m_children)
+        {
+            if (!child->m_is_dirty)
+            {
+                child->MarkDirtyDescendants();
+            }
+        }
+    }
+
+    void Transform::ComputeMatrices() const
     {
         // Compute local transform
         m_matrixLocal = Matrix(m_positionLocal, m_rotationLocal, m_scaleLocal);
 
-        // Compute world transform
+        // Compute world transform (this will also resolve the parent if it's dirty)
         if (!HasParent())
         {
             m_matrix = m_matrixLocal;
@@ -100,12 +142,9 @@ namespace Spartan
         {
             m_matrix = m_matrixLocal * GetParentTransformMatrix();
         }
-        
-        // Update children
-        for (const auto& child : m_children)
-        {
-            child->UpdateTransform();
-        }
+
+        m_is_dirty = false;
+        m_version++;
     }
 
     void Transform::SetPosition(const Vector3& position)
@@ -122,7 +161,7 @@ namespace Spartan
             return;
 
         m_positionLocal = position;
-        UpdateTransform();
+        MarkDirty();
     }
 
     void Transform::SetRotation(const Quaternion& rotation)
@@ -139,7 +178,7 @@ namespace Spartan
             return;
 
         m_rotationLocal = rotation;
-        UpdateTransform();
+        MarkDirty();
     }
 
     void Transform::SetScale(const Vector3& scale)
@@ -162,7 +201,7 @@ namespace Spartan
         m_scaleLocal.y = (m_scaleLocal.y == 0.0f) ? Helper::EPSILON : m_scaleLocal.y;
         m_scaleLocal.z = (m_scaleLocal.z == 0.0f) ? Helper::EPSILON : m_scaleLocal.z;
 
-        UpdateTransform();
+        MarkDirty();
     }
 
     void Transform::Translate(const Vector3& delta)
@@ -249,16 +288,18 @@ namespace Spartan
             // if this transform already has a parent
             if (this->HasParent())
             {
-                // assign the parent of this transform to the children
-                for (const auto& child : m_children)
+                // assign the parent of this transform to the children (iterate a copy as re-parenting modifies m_children)
+                const vector<Transform*> children = m_children;
+                for (Transform* child : children)
                 {
                     child->SetParent(GetParent());
                 }
             }
             else // if this transform doesn't have a parent
             {
-                // make the children orphans
-                for (const auto& child : m_children)
+                // make the children orphans (iterate a copy as re-parenting modifies m_children)
+                const vector<Transform*> children = m_children;
+                for (Transform* child : children)
                 {
                     child->BecomeOrphan();
                 }
@@ -268,15 +309,15 @@ namespace Spartan
         // Switch parent but keep a pointer to the old one
         auto parent_old = m_parent;
         m_parent = new_parent;
-        if (parent_old) parent_old->AcquireChildren(); // update the old parent (so it removes this child)
+        if (parent_old) parent_old->UnregisterChild(this); // update the old parent (so it removes this child)
 
         // make the new parent "aware" of this transform/child
         if (m_parent)
         {
-            m_parent->AcquireChildren();
+            m_parent->RegisterChild(this);
         }
 
-        UpdateTransform();
+        MarkDirty();
     }
 
     void Transform::AddChild(Transform* child)
@@ -320,38 +361,6 @@ namespace Spartan
         return nullptr;
     }
 
-    // Searches the entire hierarchy, finds any children and saves them in m_children.
-    // This is a recursive function, the children will also find their own children and so on...
-    void Transform::AcquireChildren()
-    {
-        m_children.clear();
-        m_children.shrink_to_fit();
-
-        auto entities = GetContext()->GetSubsystem<World>()->EntityGetAll();
-        for (const auto& entity : entities)
-        {
-            if (!entity)
-                continue;
-
-            // get the possible child
-            auto possible_child = entity->GetTransform();
-
-            // if it doesn't have a parent, forget about it.
-            if (!possible_child->HasParent())
-                continue;
-
-            // if it's parent matches this transform
-            if (possible_child->GetParent()->GetId() == GetId())
-            {
-                // welcome home son
-                m_children.emplace_back(possible_child);
-
-                // make the child do the same thing all over, essentially resolving the entire hierarchy.
-                possible_child->AcquireChildren();
-            }
-        }
-    }
-
     bool Transform::IsDescendantOf(const Transform* transform) const
     {
         for (const Transform* child : transform->GetChildren())
@@ -382,6 +391,25 @@ namespace Spartan
         }
     }
 
+    void Transform::RegisterChild(Transform* child)
+    {
+        if (find(m_children.begin(), m_children.end(), child) == m_children.end())
+        {
+            m_children.emplace_back(child);
+            MarkModified();
+        }
+    }
+
+    void Transform::UnregisterChild(Transform* child)
+    {
+        const auto it = find(m_children.begin(), m_children.end(), child);
+        if (it != m_children.end())
+        {
+            m_children.erase(it);
+            MarkModified();
+        }
+    }
+
     Matrix Transform::GetParentTransformMatrix() const
     {
         return HasParent() ? GetParent()->GetMatrix() : Matrix::Identity;
@@ -401,14 +429,12 @@ namespace Spartan
         m_parent = nullptr;
 
         // Update the transform without the parent now
-        UpdateTransform();
+        MarkDirty();
 
-        // make the parent search for children,
-        // that's indirect way of making the parent "forget"
-        // about this child, since it won't be able to find it
+        // make the parent "forget" about this child
         if (temp_ref)
         {
-            temp_ref->AcquireChildren();
+            temp_ref->UnregisterChild(this);
         }
     }
 }
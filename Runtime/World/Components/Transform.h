@@ -46,24 +46,33 @@ namespace Spartan
         void Deserialize(FileStream* stream) override;
         //============================================
 
+        // Setters only mark the transform (and its descendants) as dirty, matrices are computed either once per frame by
+        // World (see UpdateHierarchy()) or on demand, when they are requested. This forces an update of this transform.
         void UpdateTransform();
 
+        // Updates this transform and any dirty descendants, parents before children (see World::UpdateTransforms())
+        void UpdateHierarchy();
+
+        // Incremented every time the world matrix is recomputed, allows caches to detect changes with a single compare
+        uint64_t GetVersion() const { Resolve(); return m_version; }
+        bool IsDirty()        const { return m_is_dirty; }
+
         //= POSITION ==============================================================
-        Math::Vector3 GetPosition()     const { return m_matrix.GetTranslation(); }
+        Math::Vector3 GetPosition()     const { return GetMatrix().GetTranslation(); }
         const auto& GetPositionLocal()  const { return m_positionLocal; }
         void SetPosition(const Math::Vector3& position);
         void SetPositionLocal(const Math::Vector3& position);
         //=========================================================================
 
         //= ROTATION ===========================================================
-        Math::Quaternion GetRotation() const { return m_matrix.GetRotation(); }
+        Math::Quaternion GetRotation() const { return GetMatrix().GetRotation(); }
         const auto& GetRotationLocal() const { return m_rotationLocal; }
         void SetRotation(const Math::Quaternion& rotation);
         void SetRotationLocal(const Math::Quaternion& rotation);
         //======================================================================
 
         //= SCALE =======================================================
-        auto GetScale()             const { return m_matrix.GetScale(); }
+        auto GetScale()             const { return GetMatrix().GetScale(); }
         const auto& GetScaleLocal() const { return m_scaleLocal; }
         void SetScale(const Math::Vector3& scale);
         void SetScaleLocal(const Math::Vector3& scale);
@@ -96,28 +105,36 @@ namespace Spartan
         Transform* GetChildByIndex(uint32_t index);
         Transform* GetChildByName(const std::string& name);
         const std::vector<Transform*>& GetChildren() const    { return m_children; }
-    
-        void AcquireChildren();
+
         bool IsDescendantOf(const Transform* transform) const;
         void GetDescendants(std::vector<Transform*>* descendants);
         //======================================================================================
 
         void LookAt(const Math::Vector3& v)                       { m_lookAt = v; }
-        const Math::Matrix& GetMatrix()                     const { return m_matrix; }
-        const Math::Matrix& GetLocalMatrix()                const { return m_matrixLocal; }
+        const Math::Matrix& GetMatrix()                     const { Resolve(); return m_matrix; }
+        const Math::Matrix& GetLocalMatrix()                const { Resolve(); return m_matrixLocal; }
         const Math::Matrix& GetMatrixPrevious()             const { return m_matrix_previous; }
         void SetWvpLastFrame(const Math::Matrix& matrix)          { m_matrix_previous = matrix;}
 
     private:
         Math::Matrix GetParentTransformMatrix() const;
+        void MarkDirty();
+        void MarkDirtyDescendants();
+        void RegisterChild(Transform* child);
+        void UnregisterChild(Transform* child);
+        void Resolve() const { if (m_is_dirty) ComputeMatrices(); }
+        void ComputeMatrices() const;
 
         // local
         Math::Vector3 m_positionLocal;
         Math::Quaternion m_rotationLocal;
         Math::Vector3 m_scaleLocal;
 
-        Math::Matrix m_matrix;
-        Math::Matrix m_matrixLocal;
+        // Computed lazily, a dirty transform implies that all of its descendants are dirty too
+        mutable Math::Matrix m_matrix;
+        mutable Math::Matrix m_matrixLocal;
+        mutable bool m_is_dirty     = true;
+        mutable uint64_t m_version  = 0;
         Math::Vector3 m_lookAt;
 
         Transform* m_parent; // the parent of this transform
@@ -72,6 +72,49 @@ namespace Spartan
         m_components.clear();
     }
 
+    void Entity::SetName(const string& name)
+    {
+        if (name == m_name)
+            return;
+
+        const string name_previous = m_name;
+        m_name          = name;
+        m_is_modified   = true;
+        m_context->GetSubsystem<World>()->EntityReindex(this, m_id, name_previous);
+    }
+
+    void Entity::SetId(const uint32_t id)
+    {
+        if (id == m_id)
+            return;
+
+        const uint32_t id_previous = m_id;
+        m_id            = id;
+        m_is_modified   = true;
+        m_context->GetSubsystem<World>()->EntityReindex(this, id_previous, m_name);
+    }
+
+    void Entity::SetActive(const bool active)
+    {
+        m_is_active     = active;
+        m_is_modified   = true;
+
+        if (World* world = m_context->GetSubsystem<World>())
+        {
+            world->EntityChanged(this);
+        }
+    }
+
+    void Entity::OnComponentsChanged()
+    {
+        m_is_modified = true;
+
+        if (World* world = m_context->GetSubsystem<World>())
+        {
+            world->EntityArchetypeUpdate(this);
+        }
+    }
+
     void Entity::Clone()
     {
         auto scene = m_context->GetSubsystem<World>();
@@ -170,9 +213,12 @@ namespace Spartan
                 stream->Write(component->GetId());
             }
 
+            // Each component is prefixed with its size, so that it can be deserialized on its own (see DeserializeComponents())
             for (const auto& component : m_components)
             {
+                const uint64_t position = stream->Reserve<uint32_t>();
                 component->Serialize(stream);
+                stream->Patch(position, static_cast<uint32_t>(stream->GetWritePosition() - position - sizeof(uint32_t)));
             }
         }
 
@@ -205,14 +251,15 @@ namespace Spartan
         }
     }
 
+    // Reads world files which predate the chunked format (see World::LoadFromFile()), their components are not size prefixed
     void Entity::Deserialize(FileStream* stream, Transform* parent)
     {
         // BASIC DATA
         {
             stream->Read(&m_is_active);
             stream->Read(&m_hierarchy_visibility);
-            stream->Read(&m_id);
-            stream->Read(&m_name);
+            SetId(stream->ReadAs<uint32_t>());
+            SetName(stream->ReadAs<string>());
         }
 
         // COMPONENTS
@@ -264,15 +311,106 @@ namespace Spartan
             {
                 child.lock()->Deserialize(stream, GetTransform());
             }
+        }
 
-            if (m_transform)
+        // Make the scene resolve
+        FIRE_EVENT(EventType::WorldResolve);
+    }
+
+    // Components which don't touch shared state while they are deserialized. Renderables are not one of them, as they
+    // create geometry buffers, load their default material through the resource cache and notify the world of changes.
+    static bool can_deserialize_detached(const ComponentType type)
+    {
+        return type == ComponentType::Transform || type == ComponentType::Camera;
+    }
+
+    void Entity::DeserializeDetached(FileStream* stream, Transform* parent, vector<EntityDetached>& entities)
+    {
+        const size_t index = entities.size();
+        entities.push_back({ GetPtrShared(), parent });
+
+        // BASIC DATA
+        {
+            stream->Read(&m_is_active);
+            stream->Read(&m_hierarchy_visibility);
+            SetId(stream->ReadAs<uint32_t>());
+            SetName(stream->ReadAs<string>());
+        }
+
+        // COMPONENTS
+        {
+            vector<EntityDetached::Component> components(stream->ReadAs<uint32_t>());
+            for (EntityDetached::Component& component : components)
+            {
+                component.type  = static_cast<ComponentType>(stream->ReadAs<uint32_t>());
+                component.id    = stream->ReadAs<uint32_t>();
+            }
+
+            for (EntityDetached::Component& component : components)
             {
-                m_transform->AcquireChildren();
+                component.data = stream->ReadView();
             }
+
+            // The rest (physics, audio, scripts etc.) are deserialized by the world once the entities have been added to it
+            vector<EntityDetached::Component> components_detached;
+            for (const EntityDetached::Component& component : components)
+            {
+                if (can_deserialize_detached(component.type))
+                {
+                    components_detached.emplace_back(component);
+                }
+                else
+                {
+                    entities[index].components_deferred.emplace_back(component);
+                }
+            }
+
+            DeserializeComponents(components_detached, false);
         }
 
-        // Make the scene resolve
-        FIRE_EVENT(EventType::WorldResolve);
+        // CHILDREN
+        {
+            const auto children_count = stream->ReadAs<uint32_t>();
+
+            // Children IDs
+            vector<shared_ptr<Entity>> children;
+            for (uint32_t i = 0; i < children_count; i++)
+            {
+                shared_ptr<Entity> child = make_shared<Entity>(m_context);
+                child->SetId(stream->ReadAs<uint32_t>());
+                children.emplace_back(child);
+            }
+
+            // Children
+            for (const auto& child : children)
+            {
+                child->DeserializeDetached(stream, GetTransform(), entities);
+            }
+        }
+    }
+
+    void Entity::DeserializeComponents(const vector<EntityDetached::Component>& components, const bool resolve /*= true*/)
+    {
+        // Create all the components first, as some depend on each other (see Deserialize())
+        vector<IComponent*> components_added;
+        for (const EntityDetached::Component& component : components)
+        {
+            components_added.emplace_back(AddComponent(component.type, component.id));
+        }
+
+        for (uint32_t i = 0; i < static_cast<uint32_t>(components.size()); i++)
+        {
+            if (components_added[i])
+            {
+                FileStream stream(components[i].data);
+                components_added[i]->Deserialize(&stream);
+            }
+        }
+
+        if (resolve)
+        {
+            FIRE_EVENT(EventType::WorldResolve);
+        }
     }
 
     IComponent* Entity::AddComponent(const ComponentType type, uint32_t id /*= 0*/)
@@ -322,19 +460,26 @@ namespace Spartan
             }
         }
 
+        if (component_type == ComponentType::Unknown)
+            return;
+
         // The script component can have multiple instance, so only remove
         // it's flag if there are no more components of that type left
-        bool others_of_same_type_exist = false;
-        for (auto it = m_components.begin(); it != m_components.end(); ++it)
+        IComponent* other_of_same_type = nullptr;
+        for (auto it = m_components.begin(); it != m_components.end() && !other_of_same_type; ++it)
         {
-            others_of_same_type_exist = ((*it)->GetType() == component_type) ? true : others_of_same_type_exist;
+            other_of_same_type = ((*it)->GetType() == component_type) ? (*it).get() : nullptr;
         }
 
-        if (!others_of_same_type_exist)
+        m_components_by_type[static_cast<uint32_t>(component_type)] = other_of_same_type;
+        if (!other_of_same_type)
         {
             m_component_mask &= ~GetComponentMask(component_type);
         }
 
+        // Update the archetype this entity belongs to
+        OnComponentsChanged();
+
         // Make the scene resolve
         FIRE_EVENT(EventType::WorldResolve);
     }
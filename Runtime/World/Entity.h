@@ -23,6 +23,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES =====================
 #include <vector>
+#include <array>
+#include <limits>
+#include <span>
+#include "EntityHandle.h"
+#include "ComponentPool.h"
 #include "../Core/EventSystem.h"
 #include "Components/IComponent.h"
 //================================
@@ -32,6 +37,22 @@ namespace Spartan
     class Context;
     class Transform;
     class Renderable;
+    class Entity;
+
+    // An entity which was deserialized outside of the world, see Entity::DeserializeDetached()
+    struct EntityDetached
+    {
+        struct Component
+        {
+            ComponentType type = ComponentType::Unknown;
+            uint32_t id        = 0;
+            std::span<const std::byte> data;
+        };
+
+        std::shared_ptr<Entity> entity;
+        Transform* parent = nullptr;
+        std::vector<Component> components_deferred; // components which have to be deserialized by the world's thread
+    };
     
     class SPARTAN_CLASS Entity : public Spartan_Object, public std::enable_shared_from_this<Entity>
     {
@@ -46,15 +67,32 @@ namespace Spartan
         void Serialize(FileStream* stream);
         void Deserialize(FileStream* stream, Transform* parent);
 
+        // Deserializes this entity and its descendants without adding them to the world, so that different hierarchies can be
+        // deserialized in parallel. Entities are appended parents first, the world adds them and deserializes the deferred components.
+        void DeserializeDetached(FileStream* stream, Transform* parent, std::vector<EntityDetached>& entities);
+        // Detached entities (see DeserializeDetached()) don't resolve the world, it's resolved once they are added to it
+        void DeserializeComponents(const std::vector<EntityDetached::Component>& components, bool resolve = true);
+
         //= PROPERTIES ===================================================================================================
         const std::string& GetName() const                              { return m_name; }
-        void SetName(const std::string& name)                           { m_name = name; }
+        void SetName(const std::string& name);
+
+        // Hides Spartan_Object::SetId() so that the world's lookup indices stay in sync
+        void SetId(uint32_t id);
+
+        // Assigned by the world when the entity is created
+        EntityHandle GetHandle() const                                  { return m_handle; }
+        void SetHandle(const EntityHandle handle)                       { m_handle = handle; }
 
         bool IsActive() const                                           { return m_is_active; }
-        void SetActive(const bool active)                               { m_is_active = active; }
+        void SetActive(bool active);
 
         bool IsVisibleInHierarchy() const                               { return m_hierarchy_visibility; }
-        void SetHierarchyVisibility(const bool hierarchy_visibility)    { m_hierarchy_visibility = hierarchy_visibility; }
+        void SetHierarchyVisibility(const bool hierarchy_visibility)    { m_hierarchy_visibility = hierarchy_visibility; m_is_modified = true; }
+
+        // Whether the entity has changed since the world was last saved or loaded, see World::SaveToFile()
+        bool IsModified() const                                         { return m_is_modified; }
+        void SetModified(const bool modified)                           { m_is_modified = modified; }
         //================================================================================================================
 
         // Adds a component of type T
@@ -67,12 +105,16 @@ namespace Spartan
             if (HasComponent(type) && type != ComponentType::Script)
                 return GetComponent<T>();
 
-            // Create a new component
-            std::shared_ptr<T> component = std::make_shared<T>(m_context, this, id);
+            // Create a new component (components of the same type are allocated next to each other)
+            std::shared_ptr<T> component = std::allocate_shared<T>(ComponentAllocator<T>(), m_context, this, id);
 
             // Save new component
             m_components.emplace_back(std::static_pointer_cast<IComponent>(component));
             m_component_mask |= GetComponentMask(type);
+            if (!m_components_by_type[static_cast<uint32_t>(type)])
+            {
+                m_components_by_type[static_cast<uint32_t>(type)] = component.get();
+            }
 
             // Caching of rendering performance critical components
             if constexpr (std::is_same<T, Transform>::value)    { m_transform   = static_cast<Transform*>(component.get()); }
@@ -82,6 +124,9 @@ namespace Spartan
             component->SetType(type);
             component->OnInitialize();
 
+            // Update the archetype this entity belongs to
+            OnComponentsChanged();
+
             // Make the scene resolve
             FIRE_EVENT(EventType::WorldResolve);
 
@@ -100,13 +145,13 @@ namespace Spartan
             if (!HasComponent(type))
                 return nullptr;
 
-            for (const auto& component : m_components)
-            {
-                if (component->GetType() == type)
-                    return static_cast<T*>(component.get());
-            }
+            return static_cast<T*>(m_components_by_type[static_cast<uint32_t>(type)]);
+        }
 
-            return nullptr;
+        // Returns the first component of the given type (if it exists)
+        IComponent* GetComponentByType(const ComponentType type) const
+        {
+            return type != ComponentType::Unknown ? m_components_by_type[static_cast<uint32_t>(type)] : nullptr;
         }
 
         // Returns any components of type T (if they exist)
@@ -133,6 +178,9 @@ namespace Spartan
         // Checks if a component exists
         constexpr bool HasComponent(const ComponentType type) { return m_component_mask & GetComponentMask(type); }
 
+        // A bit per component type
+        uint32_t GetComponentMask() const { return m_component_mask; }
+
         // Checks if a component exists
         template <class T>
         bool HasComponent() { return HasComponent(IComponent::TypeToEnum<T>()); }
@@ -151,6 +199,7 @@ namespace Spartan
                     component->OnRemove();
                     it = m_components.erase(it);
                     m_component_mask &= ~GetComponentMask(type);
+                    m_components_by_type[static_cast<uint32_t>(type)] = nullptr;
                 }
                 else
                 {
@@ -158,8 +207,11 @@ namespace Spartan
                 }
             }
 
+            // Update the archetype this entity belongs to
+            OnComponentsChanged();
+
             // Make the scene resolve
-            FIRE_EVENT(Event_World_Resolve_Pending);
+            FIRE_EVENT(EventType::WorldResolve);
         }
 
         void RemoveComponentById(uint32_t id);
@@ -173,7 +225,14 @@ namespace Spartan
         Renderable* GetRenderable() const       { return m_renderable; }
         std::shared_ptr<Entity> GetPtrShared()  { return shared_from_this(); }
 
+        // Location in the world's archetype storage (managed by the world)
+        static constexpr uint32_t archetype_invalid = std::numeric_limits<uint32_t>::max();
+        uint32_t GetArchetype() const                                       { return m_archetype; }
+        uint32_t GetArchetypeRow() const                                    { return m_archetype_row; }
+        void SetArchetype(const uint32_t archetype, const uint32_t row)     { m_archetype = archetype; m_archetype_row = row; }
+
     private:
+        void OnComponentsChanged();
         constexpr uint32_t GetComponentMask(ComponentType type) { return static_cast<uint32_t>(1) << static_cast<uint32_t>(type); }
 
         std::string m_name          = "Entity";
@@ -182,9 +241,14 @@ namespace Spartan
         Transform* m_transform      = nullptr;
         Renderable* m_renderable    = nullptr;
         bool m_destruction_pending  = false;
+        bool m_is_modified          = true;
+        EntityHandle m_handle;
         
         // Components
         std::vector<std::shared_ptr<IComponent>> m_components;
-        uint32_t m_component_mask = 0;
+        std::array<IComponent*, component_type_count> m_components_by_type = {}; // first component of each type, for constant time lookups
+        uint32_t m_component_mask   = 0;
+        uint32_t m_archetype        = archetype_invalid;
+        uint32_t m_archetype_row    = 0;
     };
 }
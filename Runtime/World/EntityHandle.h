@@ -0,0 +1,50 @@
+/*
+Copyright(c) 2016-2021 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ======
+#include <cstdint>
+#include <limits>
+//=================
+
+namespace Spartan
+{
+    // A cheap, copyable reference to an entity. It's resolved via World::EntityGet(), which returns
+    // null if the entity has been removed in the meantime (its slot's generation will have moved on).
+    struct EntityHandle
+    {
+        static constexpr uint32_t slot_invalid = std::numeric_limits<uint32_t>::max();
+
+        EntityHandle() = default;
+        EntityHandle(const uint32_t slot, const uint32_t generation) : slot(slot), generation(generation) {}
+
+        bool IsNull() const                                 { return slot == slot_invalid; }
+        uint64_t GetPacked() const                          { return (static_cast<uint64_t>(generation) << 32) | slot; }
+        static EntityHandle FromPacked(const uint64_t value){ return EntityHandle(static_cast<uint32_t>(value), static_cast<uint32_t>(value >> 32)); }
+
+        bool operator==(const EntityHandle& rhs) const      { return slot == rhs.slot && generation == rhs.generation; }
+        bool operator!=(const EntityHandle& rhs) const      { return !(*this == rhs); }
+
+        uint32_t slot       = slot_invalid;
+        uint32_t generation = 0;
+    };
+}
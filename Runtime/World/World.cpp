@@ -26,6 +26,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Components/Transform.h"
 #include "Components/Camera.h"
 #include "Components/Light.h"
+#include "Components/Renderable.h"
 #include "Components/Environment.h"
 #include "Components/AudioListener.h"
 #include "../Resource/ResourceCache.h"
@@ -34,6 +35,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Profiling/Profiler.h"
 #include "../Rendering/Renderer.h"
 #include "../Input/Input.h"
+#include "../Threading/Threading.h"
 #include "../RHI/RHI_Device.h"
 //=====================================
 
@@ -44,6 +46,10 @@ using namespace Spartan::Math;
 
 namespace Spartan
 {
+    // World files start with the magic, followed by the version. Files which predate the chunked format start with the root entity count.
+    static constexpr uint32_t world_file_magic      = 0x444C5257; // "WRLD"
+    static constexpr uint32_t world_file_version    = 1;
+
     World::World(Context* context) : ISubsystem(context)
     {
         // Subscribe to events
@@ -52,14 +58,19 @@ namespace Spartan
 
     World::~World()
     {
+        // The spatial index is destroyed before the entities, so they shouldn't try to remove themselves from it
+        SpatialIndexClear();
+
         m_input     = nullptr;
         m_profiler  = nullptr;
+        m_threading = nullptr;
     }
 
     bool World::Initialize()
     {
         m_input     = m_context->GetSubsystem<Input>();
         m_profiler  = m_context->GetSubsystem<Profiler>();
+        m_threading = m_context->GetSubsystem<Threading>();
 
         CreateCamera();
         CreateEnvironment();
@@ -108,26 +119,145 @@ namespace Spartan
             }
         }
 
+        // Transforms which changed during this frame resolve on demand here, the renderer updates the rest in parallel
+        UpdateSpatialIndex();
+
         if (m_resolve)
         {
-            // Update dirty entities
+            // Remove the entities marked for destruction, removing an entity marks its children so they are appended as we go
+            for (size_t i = 0; i < m_entities_removed.size(); i++)
             {
-                // Make a copy so we can iterate while removing entities
-                auto entities_copy = m_entities;
+                const shared_ptr<Entity> entity = m_entities_removed[i];
+                _EntityRemove(entity);
+            }
+            m_entities_removed.clear();
+
+            // Notify Renderer of the entities which changed (by pointer, so that the entities are not copied)
+            vector<shared_ptr<Entity>> entities_changed;
+            {
+                lock_guard<mutex> lock(m_entities_changed_mutex);
+                entities_changed.swap(m_entities_changed);
+                m_resolve = false;
+            }
+            FIRE_EVENT_DATA(EventType::WorldResolved, &entities_changed);
+        }
+    }
 
-                for (shared_ptr<Entity>& entity : entities_copy)
+    void World::UpdateTransforms()
+    {
+        SCOPED_TIME_BLOCK(m_profiler);
+
+        vector<EntityHandle> queued;
+        {
+            lock_guard<mutex> lock(m_transforms_queued_mutex);
+            queued.swap(m_transforms_queued);
+        }
+
+        // Resolve the queued transforms, skipping entities which have been removed since and duplicates
+        m_transforms_dirty.clear();
+        for (const EntityHandle handle : queued)
+        {
+            if (Entity* entity = EntityGet(handle))
+            {
+                m_transforms_dirty.emplace_back(entity->GetTransform());
+            }
+        }
+        sort(m_transforms_dirty.begin(), m_transforms_dirty.end());
+        m_transforms_dirty.erase(unique(m_transforms_dirty.begin(), m_transforms_dirty.end()), m_transforms_dirty.end());
+
+        // Keep the top-most ones, the hierarchies below them don't overlap so they can be updated in parallel
+        const vector<Transform*> transforms_queued = m_transforms_dirty;
+        const auto is_queued = [&transforms_queued](Transform* transform) { return binary_search(transforms_queued.begin(), transforms_queued.end(), transform); };
+        m_transforms_dirty.erase(remove_if(m_transforms_dirty.begin(), m_transforms_dirty.end(), [&is_queued](Transform* transform)
+        {
+            for (Transform* parent = transform->GetParent(); parent; parent = parent->GetParent())
+            {
+                if (is_queued(parent))
+                    return true;
+            }
+
+            return false;
+        }), m_transforms_dirty.end());
+
+        m_threading->AddTaskLoop([this](const uint32_t start, const uint32_t end)
+        {
+            for (uint32_t i = start; i < end; i++)
+            {
+                m_transforms_dirty[i]->UpdateHierarchy();
+            }
+        }, static_cast<uint32_t>(m_transforms_dirty.size()));
+    }
+
+    void World::TransformDirty(Transform* transform)
+    {
+        // Entities which are not part of the world yet have a null handle, EntityAdd() queues them instead
+        const EntityHandle handle = transform->GetEntity()->GetHandle();
+        if (handle.IsNull())
+            return;
+
+        lock_guard<mutex> lock(m_transforms_queued_mutex);
+        m_transforms_queued.emplace_back(handle);
+    }
+
+    void World::UpdateSpatialIndex()
+    {
+        SCOPED_TIME_BLOCK(m_profiler);
+
+        Query<Renderable>([this](Entity* entity, Renderable* renderable)
+        {
+            uint32_t proxy = renderable->GetSpatialProxy();
+
+            // Inactive entities are not indexed
+            if (!entity->IsActive())
+            {
+                if (proxy != Renderable::spatial_proxy_invalid)
                 {
-                    if (entity->IsPendingDestruction())
-                    {
-                        _EntityRemove(entity);
-                    }
+                    SpatialIndexRemove(renderable);
                 }
+
+                return;
+            }
+
+            // Only renderables which moved or had their geometry changed need to be updated
+            const uint64_t version = entity->GetTransform()->GetVersion();
+            if (proxy != Renderable::spatial_proxy_invalid && renderable->GetSpatialVersion() == version)
+                return;
+
+            const BoundingBox& aabb = renderable->GetAabb();
+            if (proxy == Renderable::spatial_proxy_invalid)
+            {
+                proxy = m_spatial_index.ProxyCreate(aabb, entity);
+            }
+            else
+            {
+                m_spatial_index.ProxyMove(proxy, aabb);
             }
 
-            // Notify Renderer
-            FIRE_EVENT_DATA(EventType::WorldResolved, m_entities);
-            m_resolve = false;
+            renderable->SetSpatialProxy(proxy, version);
+        });
+    }
+
+    void World::SpatialIndexRemove(Renderable* renderable)
+    {
+        const uint32_t proxy = renderable->GetSpatialProxy();
+        if (proxy == Renderable::spatial_proxy_invalid)
+            return;
+
+        m_spatial_index.ProxyDestroy(proxy);
+        renderable->SetSpatialProxy(Renderable::spatial_proxy_invalid, 0);
+    }
+
+    void World::SpatialIndexClear()
+    {
+        for (const shared_ptr<Entity>& entity : m_entities)
+        {
+            if (Renderable* renderable = entity->GetRenderable())
+            {
+                renderable->SetSpatialProxy(Renderable::spatial_proxy_invalid, 0);
+            }
         }
+
+        m_spatial_index.Clear();
     }
 
     void World::New()
@@ -168,22 +298,60 @@ namespace Spartan
 
         ProgressTracker::Get().SetJobCount(ProgressType::World, root_entity_count);
 
-        // Save root entity count
+        // Header
+        file->Write(world_file_magic);
+        file->Write(world_file_version);
         file->Write(root_entity_count);
 
-        // Save root entity IDs
-        for (const auto& root : root_actors)
+        // Chunk table, the offset and the size of each root entity's hierarchy, it's patched once the chunks have been written
+        vector<uint64_t> chunk_table_positions(root_entity_count);
+        for (uint64_t& position : chunk_table_positions)
         {
-            file->Write(root->GetId());
+            position = file->Reserve<uint64_t>();
+            file->Reserve<uint64_t>();
         }
 
-        // Save root entities
-        for (const auto& root : root_actors)
+        // Chunks, a root entity saves its descendants too. The hierarchies are serialized to memory in parallel,
+        // unless nothing in them has changed since the last save or load, in which case the previous chunk is reused.
+        vector<vector<std::byte>> chunks(root_entity_count);
+        m_threading->AddTaskLoop([this, &root_actors, &chunks](uint32_t start, uint32_t end)
         {
-            root->Serialize(file.get());
+            for (uint32_t i = start; i < end; i++)
+            {
+                Entity* root = root_actors[i].get();
+
+                // Handles are unique, so the chunks of different roots are distinct elements which can be moved out concurrently
+                const auto it = m_chunks.find(root->GetHandle().GetPacked());
+                if (it != m_chunks.end() && !IsHierarchyModified(root))
+                {
+                    chunks[i] = move(it->second);
+                    continue;
+                }
+
+                FileStream stream;
+                root->Serialize(&stream);
+                chunks[i] = move(stream.GetMemory());
+            }
+        }, root_entity_count);
+
+        m_chunks.clear();
+        for (uint32_t i = 0; i < root_entity_count; i++)
+        {
+            const uint64_t offset = file->GetWritePosition();
+            file->WriteRaw(chunks[i]);
+
+            file->Patch(chunk_table_positions[i], offset);
+            file->Patch(chunk_table_positions[i] + sizeof(uint64_t), file->GetWritePosition() - offset);
+
+            m_chunks[root_actors[i]->GetHandle().GetPacked()] = move(chunks[i]);
             ProgressTracker::Get().IncrementJobsDone(ProgressType::World);
         }
 
+        for (const shared_ptr<Entity>& entity : m_entities)
+        {
+            entity->SetModified(false);
+        }
+
         // Finish with progress report and timer
         ProgressTracker::Get().SetIsLoading(ProgressType::World, false);
         LOG_INFO("Saving took %.2f ms", timer.GetElapsedTimeMs());
@@ -202,11 +370,41 @@ namespace Spartan
             return false;
         }
 
-        // Open file
-        auto file = make_unique<FileStream>(file_path, FileStream_Read);
+        // Open file, it's memory mapped so that the chunks can be deserialized in place
+        auto file = make_unique<FileStream>(file_path, FileStream_Read | FileStream_Mmap);
         if (!file->IsOpen())
             return false;
 
+        // Files which predate the chunked format start with the root entity count instead of the magic.
+        // The header and the chunk table are validated before anything is cleared, so that the current world survives an invalid file.
+        const uint32_t magic = file->ReadAs<uint32_t>();
+        const bool is_chunked = magic == world_file_magic;
+        vector<span<const std::byte>> chunks;
+        if (is_chunked)
+        {
+            const uint32_t version = file->ReadAs<uint32_t>();
+            if (version > world_file_version)
+            {
+                LOG_ERROR("Unsupported world file version %d, the latest supported version is %d", version, world_file_version);
+                return false;
+            }
+
+            // Every hierarchy serializes at least its root, so an empty chunk means that the table is truncated or points past the end of the file
+            chunks.resize(file->ReadAs<uint32_t>());
+            for (span<const std::byte>& chunk : chunks)
+            {
+                const uint64_t offset   = file->ReadAs<uint64_t>();
+                const uint64_t size     = file->ReadAs<uint64_t>();
+                chunk                   = file->GetView(offset, size);
+
+                if (chunk.empty())
+                {
+                    LOG_ERROR("\"%s\" has an invalid chunk table.", file_path.c_str());
+                    return false;
+                }
+            }
+        }
+
         // Start progress report and timing
         ProgressTracker::Get().Reset(ProgressType::World);
         ProgressTracker::Get().SetIsLoading(ProgressType::World, true);
@@ -228,9 +426,92 @@ namespace Spartan
         // Notify subsystems that need to load data
         FIRE_EVENT(EventType::WorldLoad);
 
-        // Load root entity count
-        const uint32_t root_entity_count = file->ReadAs<uint32_t>();
+        const bool loaded = is_chunked ? LoadChunks(chunks) : LoadLegacy(file.get(), magic);
+
+        ProgressTracker::Get().SetIsLoading(ProgressType::World, false);
+
+        if (!loaded)
+        {
+            LOG_ERROR("Failed to load \"%s\".", file_path.c_str());
+            return false;
+        }
+
+        LOG_INFO("Loading took %.2f ms", timer.GetElapsedTimeMs());
+
+        FIRE_EVENT(EventType::WorldLoaded);
+
+        return true;
+    }
+
+    bool World::LoadChunks(const vector<span<const std::byte>>& chunks)
+    {
+        // The chunk table has already been read and validated by LoadFromFile()
+        const uint32_t root_entity_count = static_cast<uint32_t>(chunks.size());
+        ProgressTracker::Get().SetJobCount(ProgressType::World, root_entity_count);
+
+        // Deserialize the hierarchies in parallel, the entities are not part of the world yet and only the components
+        // which don't touch shared state are deserialized by the threads (see Entity::DeserializeDetached())
+        vector<vector<EntityDetached>> chunk_entities(root_entity_count);
+        m_threading->AddTaskLoop([this, &chunks, &chunk_entities](uint32_t start, uint32_t end)
+        {
+            for (uint32_t i = start; i < end; i++)
+            {
+                FileStream stream(chunks[i]);
+                make_shared<Entity>(m_context)->DeserializeDetached(&stream, nullptr, chunk_entities[i]);
+            }
+        }, root_entity_count, 1);
+
+        // Add the entities to the world, in file order and parents first
+        for (uint32_t i = 0; i < root_entity_count; i++)
+        {
+            for (EntityDetached& entity : chunk_entities[i])
+            {
+                EntityAdd(entity.entity);
+
+                if (entity.parent)
+                {
+                    entity.entity->GetTransform()->SetParent(entity.parent);
+                }
+
+                entity.entity->DeserializeComponents(entity.components_deferred);
+            }
+
+            // Keep the chunk, so that it can be reused if the hierarchy doesn't change until the next save
+            if (!chunk_entities[i].empty())
+            {
+                m_chunks[chunk_entities[i].front().entity->GetHandle().GetPacked()].assign(chunks[i].begin(), chunks[i].end());
+            }
+
+            ProgressTracker::Get().IncrementJobsDone(ProgressType::World);
+        }
+
+        for (const shared_ptr<Entity>& entity : m_entities)
+        {
+            entity->SetModified(false);
+        }
+
+        // The entities don't fire WorldResolve while they are deserialized on other threads, so resolve once for all of them
+        m_resolve = true;
+
+        return true;
+    }
+
+    bool World::IsHierarchyModified(const Entity* entity)
+    {
+        if (entity->IsModified())
+            return true;
+
+        for (const Transform* child : entity->GetTransform()->GetChildren())
+        {
+            if (IsHierarchyModified(child->GetEntity()))
+                return true;
+        }
 
+        return false;
+    }
+
+    bool World::LoadLegacy(FileStream* file, const uint32_t root_entity_count)
+    {
         ProgressTracker::Get().SetJobCount(ProgressType::World, root_entity_count);
 
         // Load root entity IDs
@@ -243,15 +524,10 @@ namespace Spartan
         // Serialize root entities
         for (uint32_t i = 0; i < root_entity_count; i++)
         {
-            m_entities[i]->Deserialize(file.get(), nullptr);
+            m_entities[i]->Deserialize(file, nullptr);
             ProgressTracker::Get().IncrementJobsDone(ProgressType::World);
         }
 
-        ProgressTracker::Get().SetIsLoading(ProgressType::World, false);
-        LOG_INFO("Loading took %.2f ms", timer.GetElapsedTimeMs());
-
-        FIRE_EVENT(EventType::WorldLoaded);
-
         return true;
     }
 
@@ -267,11 +543,26 @@ namespace Spartan
 
     shared_ptr<Entity> World::EntityCreate(bool is_active /*= true*/)
     {
-        shared_ptr<Entity> entity = m_entities.emplace_back(make_shared<Entity>(m_context));
+        shared_ptr<Entity> entity = make_shared<Entity>(m_context);
         entity->SetActive(is_active);
+        EntityAdd(entity);
         return entity;
     }
 
+    void World::EntityAdd(const shared_ptr<Entity>& entity)
+    {
+        m_entities.emplace_back(entity);
+        entity->SetHandle(EntitySlotAllocate(entity.get(), static_cast<uint32_t>(m_entities.size() - 1)));
+        EntityIndexAdd(entity.get(), static_cast<uint32_t>(m_entities.size() - 1));
+        EntityArchetypeUpdate(entity.get());
+
+        // Transforms which became dirty before the entity was added couldn't be queued
+        if (entity->GetTransform()->IsDirty())
+        {
+            TransformDirty(entity->GetTransform());
+        }
+    }
+
     bool World::EntityExists(const shared_ptr<Entity>& entity)
     {
         if (!entity)
@@ -285,9 +576,13 @@ namespace Spartan
         if (!entity)
             return;
 
+        if (entity->IsPendingDestruction())
+            return;
+
         // Mark for destruction but don't delete now
         // as the Renderer might still be using it.
         entity->MarkForDestruction();
+        m_entities_removed.emplace_back(entity);
         m_resolve = true;
     }
 
@@ -307,11 +602,10 @@ namespace Spartan
 
     const shared_ptr<Entity>& World::EntityGetByName(const string& name)
     {
-        for (const auto& entity : m_entities)
-        {
-            if (entity->GetName() == name)
-                return entity;
-        }
+        // If multiple entities share the name, any of them can be returned
+        const auto it = m_entity_names.find(name);
+        if (it != m_entity_names.end())
+            return EntityGetById(it->second);
 
         static shared_ptr<Entity> empty;
         return empty;
@@ -319,16 +613,191 @@ namespace Spartan
 
     const shared_ptr<Entity>& World::EntityGetById(const uint32_t id)
     {
-        for (const auto& entity : m_entities)
-        {
-            if (entity->GetId() == id)
-                return entity;
-        }
+        const auto it = m_entity_indices.find(id);
+        if (it != m_entity_indices.end())
+            return m_entities[it->second];
 
         static shared_ptr<Entity> empty;
         return empty;
     }
 
+    void World::EntityReindex(const Entity* entity, const uint32_t id_previous, const string& name_previous)
+    {
+        // Ignore entities which don't belong to the world (yet)
+        const uint32_t index = EntityIndex(entity);
+        if (index == numeric_limits<uint32_t>::max())
+            return;
+
+        EntityIndexRemove(entity, id_previous, name_previous);
+        EntityIndexAdd(entity, index);
+    }
+
+    void World::EntityChanged(Entity* entity)
+    {
+        // Ignore entities which don't belong to the world (yet), they are queued when they are added
+        if (EntityGet(entity->GetHandle()) != entity)
+            return;
+
+        {
+            lock_guard<mutex> lock(m_entities_changed_mutex);
+
+            // An entity usually changes a few times in a row (e.g. when its components are added), a duplicate is harmless but skip the obvious ones
+            if (m_entities_changed.empty() || m_entities_changed.back().get() != entity)
+            {
+                m_entities_changed.emplace_back(entity->GetPtrShared());
+            }
+        }
+
+        m_resolve = true;
+    }
+
+    uint32_t World::EntityIndex(const Entity* entity) const
+    {
+        // Ids are not guaranteed to be unique (e.g. a loaded id can match a generated one), so membership is tested with the handle
+        if (EntityGet(entity->GetHandle()) != entity)
+            return numeric_limits<uint32_t>::max();
+
+        return m_entity_slots[entity->GetHandle().slot].index;
+    }
+
+    void World::EntityIndexAdd(const Entity* entity, const uint32_t index)
+    {
+        m_entity_indices[entity->GetId()] = index;
+        m_entity_names.emplace(entity->GetName(), entity->GetId());
+    }
+
+    void World::EntityIndexRemove(const Entity* entity, const uint32_t id, const string& name)
+    {
+        // Only remove what maps to this entity, as another entity might share the id
+        const auto it_index = m_entity_indices.find(id);
+        if (it_index != m_entity_indices.end() && m_entities[it_index->second].get() == entity)
+        {
+            m_entity_indices.erase(it_index);
+        }
+
+        const auto range = m_entity_names.equal_range(name);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second == id)
+            {
+                m_entity_names.erase(it);
+                break;
+            }
+        }
+    }
+
+    void World::EntityArchetypeUpdate(Entity* entity)
+    {
+        // Ignore entities which don't belong to the world (yet)
+        if (EntityGet(entity->GetHandle()) != entity)
+            return;
+
+        const uint32_t mask = entity->GetComponentMask();
+
+        // Move to a different archetype if the set of component types has changed
+        uint32_t index = entity->GetArchetype();
+        if (index == Entity::archetype_invalid || m_archetypes[index]->mask != mask)
+        {
+            EntityArchetypeRemove(entity);
+
+            const auto it = m_archetype_indices.find(mask);
+            if (it != m_archetype_indices.end())
+            {
+                index = it->second;
+            }
+            else
+            {
+                index = static_cast<uint32_t>(m_archetypes.size());
+                m_archetypes.emplace_back(make_unique<Archetype>())->mask = mask;
+                m_archetype_indices[mask] = index;
+            }
+
+            Archetype& archetype = *m_archetypes[index];
+            entity->SetArchetype(index, static_cast<uint32_t>(archetype.entities.size()));
+            archetype.entities.emplace_back(entity);
+            for (uint32_t type = 0; type < component_type_count; type++)
+            {
+                if (mask & (1u << type))
+                {
+                    archetype.components[type].emplace_back(nullptr);
+                }
+            }
+        }
+
+        // Refresh the component pointers (a component might have been replaced by another of the same type)
+        Archetype& archetype    = *m_archetypes[index];
+        const uint32_t row      = entity->GetArchetypeRow();
+        for (uint32_t type = 0; type < component_type_count; type++)
+        {
+            if (mask & (1u << type))
+            {
+                archetype.components[type][row] = entity->GetComponentByType(static_cast<ComponentType>(type));
+            }
+        }
+
+        EntityChanged(entity);
+    }
+
+    void World::EntityArchetypeRemove(Entity* entity)
+    {
+        const uint32_t index = entity->GetArchetype();
+        if (index == Entity::archetype_invalid)
+            return;
+
+        // Swap with the last row and pop
+        Archetype& archetype    = *m_archetypes[index];
+        const uint32_t row      = entity->GetArchetypeRow();
+        const uint32_t row_last = static_cast<uint32_t>(archetype.entities.size() - 1);
+
+        archetype.entities[row] = archetype.entities[row_last];
+        archetype.entities.pop_back();
+        for (uint32_t type = 0; type < component_type_count; type++)
+        {
+            if (archetype.mask & (1u << type))
+            {
+                archetype.components[type][row] = archetype.components[type][row_last];
+                archetype.components[type].pop_back();
+            }
+        }
+
+        if (row != row_last)
+        {
+            archetype.entities[row]->SetArchetype(index, row);
+        }
+
+        entity->SetArchetype(Entity::archetype_invalid, 0);
+    }
+
+    EntityHandle World::EntitySlotAllocate(Entity* entity, const uint32_t index_entity)
+    {
+        uint32_t index = 0;
+        if (!m_entity_slots_free.empty())
+        {
+            index = m_entity_slots_free.back();
+            m_entity_slots_free.pop_back();
+        }
+        else
+        {
+            index = static_cast<uint32_t>(m_entity_slots.size());
+            m_entity_slots.emplace_back();
+        }
+
+        m_entity_slots[index].entity = entity;
+        m_entity_slots[index].index  = index_entity;
+        return EntityHandle(index, m_entity_slots[index].generation);
+    }
+
+    void World::EntitySlotRelease(const EntityHandle handle)
+    {
+        if (EntityGet(handle) == nullptr)
+            return;
+
+        // Invalidate any outstanding handles
+        m_entity_slots[handle.slot].entity = nullptr;
+        m_entity_slots[handle.slot].generation++;
+        m_entity_slots_free.emplace_back(handle.slot);
+    }
+
     void World::Clear()
     {
         // Notify any systems that the entities are about to be cleared
@@ -336,8 +805,25 @@ namespace Spartan
         m_context->GetSubsystem<Renderer>()->Clear();
         m_context->GetSubsystem<ResourceCache>()->Clear();
 
+        SpatialIndexClear();
+
         // Clear the entities
+        for (const shared_ptr<Entity>& entity : m_entities)
+        {
+            EntitySlotRelease(entity->GetHandle());
+            entity->SetArchetype(Entity::archetype_invalid, 0);
+        }
         m_entities.clear();
+        m_archetypes.clear();
+        m_archetype_indices.clear();
+        m_entity_indices.clear();
+        m_entity_names.clear();
+        m_chunks.clear();
+        m_entities_removed.clear();
+        {
+            lock_guard<mutex> lock(m_entities_changed_mutex);
+            m_entities_changed.clear();
+        }
 
         m_resolve = true;
     }
@@ -352,26 +838,38 @@ namespace Spartan
             EntityRemove(child->GetEntity()->GetPtrShared());
         }
 
-        // Keep a reference to it's parent (in case it has one)
-        auto parent = entity->GetTransform()->GetParent();
-
-        // Remove this entity
-        for (auto it = m_entities.begin(); it < m_entities.end();)
+        // Remove this entity by swapping it with the last one (the order of m_entities is not preserved)
+        const uint32_t index = EntityIndex(entity.get());
+        if (index != numeric_limits<uint32_t>::max())
         {
-            const auto temp = *it;
-            if (temp->GetId() == entity->GetId())
+            // Let the renderer know, while the entity can still be identified as part of the world
+            EntityChanged(entity.get());
+
+            EntityIndexRemove(entity.get(), entity->GetId(), entity->GetName());
+            EntityArchetypeRemove(entity.get());
+            EntitySlotRelease(entity->GetHandle());
+            if (Renderable* renderable = entity->GetRenderable())
             {
-                it = m_entities.erase(it);
-                break;
+                SpatialIndexRemove(renderable);
             }
-            ++it;
-        }
 
-        // If there was a parent, update it
-        if (parent)
-        {
-            parent->AcquireChildren();
+            const uint32_t index_last = static_cast<uint32_t>(m_entities.size() - 1);
+            if (index != index_last)
+            {
+                m_entities[index] = move(m_entities[index_last]);
+                m_entity_slots[m_entities[index]->GetHandle().slot].index = index;
+
+                const auto it = m_entity_indices.find(m_entities[index]->GetId());
+                if (it != m_entity_indices.end() && it->second == index_last)
+                {
+                    it->second = index;
+                }
+            }
+            m_entities.pop_back();
         }
+
+        // Make the parent forget about it, now that it's no longer in the world
+        entity->GetTransform()->BecomeOrphan();
     }
 
     shared_ptr<Entity> World::CreateEnvironment()
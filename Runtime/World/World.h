@@ -25,6 +25,13 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <vector>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
+#include <span>
+#include "EntityHandle.h"
+#include "Archetype.h"
+#include "../Math/AabbTree.h"
 #include "../Core/ISubsystem.h"
 #include "../Core/Spartan_Definitions.h"
 //======================================
@@ -35,6 +42,10 @@ namespace Spartan
     class Light;
     class Input;
     class Profiler;
+    class Threading;
+    class Transform;
+    class Renderable;
+    class FileStream;
 
     class SPARTAN_CLASS World : public ISubsystem
     {
@@ -54,6 +65,13 @@ namespace Spartan
         void Resolve() { m_resolve = true; }
         bool IsLoading();
 
+        // Propagates transform changes down their hierarchies, in parallel. Systems which read transforms from multiple threads
+        // must call this first, as a dirty transform resolves itself (and its parents) when it's read. The renderer calls it once per frame.
+        void UpdateTransforms();
+
+        // Called by transforms which became dirty, only the top-most transform of a hierarchy is queued (thread safe)
+        void TransformDirty(Transform* transform);
+
         //= Entities ===========================================================
         std::shared_ptr<Entity> EntityCreate(bool is_active = true);
         bool EntityExists(const std::shared_ptr<Entity>& entity);
@@ -62,11 +80,99 @@ namespace Spartan
         const std::shared_ptr<Entity>& EntityGetByName(const std::string& name);
         const std::shared_ptr<Entity>& EntityGetById(uint32_t id);
         const auto& EntityGetAll() const    { return m_entities; }
+
+        // Returns null if the handle is invalid or the entity has been removed
+        Entity* EntityGet(const EntityHandle handle) const
+        {
+            if (handle.slot >= static_cast<uint32_t>(m_entity_slots.size()))
+                return nullptr;
+
+            const EntitySlot& slot = m_entity_slots[handle.slot];
+            return slot.generation == handle.generation ? slot.entity : nullptr;
+        }
+
+        // Keeps the lookup indices in sync, called by an entity when its id or name changes
+        void EntityReindex(const Entity* entity, uint32_t id_previous, const std::string& name_previous);
+
+        // Queues an entity whose components, active state or material changed. The next resolve passes only the queued
+        // entities to WorldResolved, so that subscribers (e.g. the renderer) can update incrementally.
+        void EntityChanged(Entity* entity);
+        //======================================================================
+
+        //= Archetypes =========================================================
+        // Invokes function(Entity*, T*...) for every entity which has all of the requested component types.
+        // Entities are grouped by their set of component types, so this only visits archetypes that match
+        // and it iterates over contiguous arrays. Adding or removing entities/components while iterating is not allowed.
+        template <typename... T, typename Function>
+        void Query(Function&& function) const
+        {
+            const uint32_t mask = ((1u << static_cast<uint32_t>(IComponent::TypeToEnum<T>())) | ...);
+
+            for (const std::unique_ptr<Archetype>& archetype : m_archetypes)
+            {
+                if ((archetype->mask & mask) != mask)
+                    continue;
+
+                const uint32_t count = static_cast<uint32_t>(archetype->entities.size());
+                for (uint32_t i = 0; i < count; i++)
+                {
+                    function(archetype->entities[i], static_cast<T*>(archetype->components[static_cast<uint32_t>(IComponent::TypeToEnum<T>())][i])...);
+                }
+            }
+        }
+
+        // Moves an entity to the archetype matching its components, called by an entity when its components change
+        void EntityArchetypeUpdate(Entity* entity);
+        //======================================================================
+
+        //= Spatial index ======================================================
+        // The renderables of active entities are kept in a bounding volume hierarchy, which is updated after the transforms.
+        // The queries invoke function(Entity*) for every entity whose renderable AABB overlaps them and only visit the
+        // parts of the hierarchy which do, adding or removing entities while querying is not allowed.
+        template <typename Function>
+        void SpatialQueryAabb(const Math::BoundingBox& box, Function&& function) const
+        {
+            m_spatial_index.QueryAabb(box, [&function](void* user_data) { function(static_cast<Entity*>(user_data)); });
+        }
+
+        template <typename Function>
+        void SpatialQuerySphere(const Math::Vector3& center, const float radius, Function&& function) const
+        {
+            m_spatial_index.QuerySphere(center, radius, [&function](void* user_data) { function(static_cast<Entity*>(user_data)); });
+        }
+
+        template <typename Function>
+        void SpatialQueryFrustum(const Math::Frustum& frustum, Function&& function, const bool ignore_near_plane = false) const
+        {
+            m_spatial_index.QueryFrustum(frustum, [&function](void* user_data) { function(static_cast<Entity*>(user_data)); }, ignore_near_plane);
+        }
+
+        // Invokes function(Entity*, float distance) for every entity whose renderable AABB is hit by the ray, in no particular order
+        template <typename Function>
+        void SpatialQueryRay(const Math::Ray& ray, Function&& function) const
+        {
+            m_spatial_index.Raycast(ray, [&function](void* user_data, const float distance) { function(static_cast<Entity*>(user_data), distance); });
+        }
+
+        // Removes a renderable from the spatial index, called by a renderable when it's removed
+        void SpatialIndexRemove(Renderable* renderable);
         //======================================================================
 
     private:
         void Clear();
+        void UpdateSpatialIndex();
+        void SpatialIndexClear();
+        bool LoadChunks(const std::vector<std::span<const std::byte>>& chunks);
+        bool LoadLegacy(FileStream* file, uint32_t root_entity_count);
+        static bool IsHierarchyModified(const Entity* entity);
+        void EntityAdd(const std::shared_ptr<Entity>& entity);
         void _EntityRemove(const std::shared_ptr<Entity>& entity);
+        uint32_t EntityIndex(const Entity* entity) const;
+        void EntityIndexAdd(const Entity* entity, uint32_t index);
+        void EntityIndexRemove(const Entity* entity, uint32_t id, const std::string& name);
+        void EntityArchetypeRemove(Entity* entity);
+        EntityHandle EntitySlotAllocate(Entity* entity, uint32_t index_entity);
+        void EntitySlotRelease(EntityHandle handle);
 
         //= COMMON ENTITY CREATION ======================
         std::shared_ptr<Entity> CreateEnvironment();
@@ -76,10 +182,41 @@ namespace Spartan
 
         std::string m_name;
         bool m_was_in_editor_mode   = false;
-        bool m_resolve              = true;
+        std::atomic<bool> m_resolve = true; // set by entities which can be deserialized by other threads
         Input* m_input              = nullptr;
         Profiler* m_profiler        = nullptr;
+        Threading* m_threading      = nullptr;
+        std::vector<Transform*> m_transforms_dirty;
+        std::vector<EntityHandle> m_transforms_queued;
+        std::mutex m_transforms_queued_mutex;
+
+        // The serialized hierarchies of the last save or load by root entity handle (ids are not unique), hierarchies which haven't been modified since are copied when saving
+        std::unordered_map<uint64_t, std::vector<std::byte>> m_chunks;
 
         std::vector<std::shared_ptr<Entity>> m_entities;
+        std::unordered_map<uint32_t, uint32_t> m_entity_indices;        // id to index in m_entities
+        std::unordered_multimap<std::string, uint32_t> m_entity_names;  // name to id
+
+        // Entities to be passed to WorldResolved and entities marked for destruction, both consumed by the next resolve
+        std::vector<std::shared_ptr<Entity>> m_entities_changed;
+        std::vector<std::shared_ptr<Entity>> m_entities_removed;
+        std::mutex m_entities_changed_mutex;
+
+        // Slot map which backs entity handles, a slot's generation is incremented when its entity is removed
+        struct EntitySlot
+        {
+            Entity* entity      = nullptr;
+            uint32_t generation = 0;
+            uint32_t index      = 0; // of the entity in m_entities
+        };
+        std::vector<EntitySlot> m_entity_slots;
+        std::vector<uint32_t> m_entity_slots_free;
+
+        // Archetype storage
+        std::vector<std::unique_ptr<Archetype>> m_archetypes;
+        std::unordered_map<uint32_t, uint32_t> m_archetype_indices; // component mask to index in m_archetypes
+
+        // Spatial index, the user data of each proxy is the entity which owns the renderable
+        Math::AabbTree m_spatial_index;
     };
 }
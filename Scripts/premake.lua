@@ -67,8 +67,9 @@ end
 solution (SOLUTION_NAME)
 	location ".."
 	systemversion "latest"
-	cppdialect "C++17"
+	cppdialect "C++latest"
 	language "C++"
+	buildoptions { "/permissive" } -- C++latest implies /permissive-, keep the existing conformance behaviour
 	platforms "x64"
 	configurations { "Release", "Debug" }
 	